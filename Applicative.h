@@ -103,19 +103,31 @@ constexpr auto operator || ( X&& x, std::initializer_list<Y> l )
 template<> struct Applicative< category::maybe_type > {
     template< template<class...>class Ptr, class X >
     static Ptr<Decay<X>> pure( X&& x ) {
-        return Just( std::forward<X>(x) );
+        return data::justLike<Ptr<Decay<X>>>( std::forward<X>(x) );
     }
 
     template< class A, class B >
     static constexpr auto ap( A&& a, B&& b ) 
-        -> decltype( Just((*std::declval<A>())(*std::declval<B>())) )
+        -> data::JustLike< A, decltype (
+            (*std::declval<A>())( *std::declval<B>() )
+        ) >
     {
         return a and b 
-            ? Just( (*std::forward<A>(a))( *std::forward<B>(b) ) )
+            ? data::justLike<A>( (*std::forward<A>(a))( *std::forward<B>(b) ) )
             : nullptr;
     }
 };
 
+/* Right f <*> Right x = Right (f x) */
+template< class L, class R > struct Applicative< data::Either<L,R> > {
+    template< class A, class B >
+    static constexpr auto ap( A&& a, B&& b )
+        -> decltype( data::operator*( std::declval<A>(), std::declval<B>() ) )
+    {
+        return data::operator*( std::forward<A>(a), std::forward<B>(b) );
+    }
+};
+
 constexpr struct Call : Binary<Call> {
     using Binary<Call>::operator();
 
@@ -163,9 +175,9 @@ template<> struct Alternative< category::maybe_type > {
         return a ? std::forward<P>(a) : std::forward<P>(b); 
     }
 
-    template< class P, class R = decltype( Just(*declval<P>()) ) > 
+    template< class P, class R = data::JustLike< P, decltype(*declval<P>()) > >
     static constexpr R alt ( const P& a, const P& b ) {
-        return a ? Just(*a) : b ? Just(*b) : nullptr;
+        return a ? data::justLike<P>(*a) : b ? data::justLike<P>(*b) : nullptr;
     }
 };
 
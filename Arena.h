@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#   if __has_include(<memory_resource>)
+#       include <memory_resource>
+#       define PURE_HAS_PMR 1
+#   endif
+#endif
+
+namespace pure {
+
+/*
+ * Arena -- a monotonic buffer: allocation bumps a pointer through a block,
+ * and when one runs out, starts a new block twice as large. Freeing does
+ * nothing; everything goes at once, on release() or when the Arena dies.
+ *
+ * Everything a pipeline builds and throws away -- every map, filter and
+ * scanl on the way to its answer -- costs a pointer bump and no free, and
+ * no lock on the global heap. Bumping is a compare-and-swap, so containers
+ * from one Arena may grow on several threads at once (par's filter does);
+ * only adding a block takes a lock.
+ */
+class Arena {
+    struct Block {
+        Block* prev;
+        char* end;
+        std::atomic<char*> top;
+    };
+
+    std::atomic<Block*> head;
+    std::mutex grow;
+    size_t next; // The size of the next block.
+
+    static char* align( char* p, size_t a ) {
+        const size_t u = reinterpret_cast<size_t>( p );
+        return p + ( (a - u % a) % a );
+    }
+
+    /* Add a block with room for n bytes at alignment a, unless one has been
+       added since the caller saw b. */
+    void addBlock( Block* b, size_t n, size_t a ) {
+        std::lock_guard<std::mutex> lock( grow );
+        if( head.load() != b )
+            return;
+
+        const size_t size = std::max( next, sizeof(Block) + n + a );
+        char* mem = static_cast<char*>( ::operator new( size ) );
+        Block* nb = new (mem) Block;
+        nb->prev = b;
+        nb->end = mem + size;
+        nb->top = mem + sizeof(Block);
+        next = 2 * size;
+        head.store( nb );
+    }
+
+  public:
+    explicit Arena( size_t initial = 4096 ) : head( nullptr ), next(initial) {
+    }
+
+    Arena( const Arena& ) = delete;
+    Arena& operator = ( const Arena& ) = delete;
+
+    ~Arena() { release(); }
+
+    void* allocate( size_t n, size_t a = alignof(std::max_align_t) ) {
+        while( true ) {
+            Block* b = head.load();
+            if( b ) {
+                char* t = b->top.load( std::memory_order_relaxed );
+                char* p = align( t, a );
+                while( p + n <= b->end ) {
+                    if( b->top.compare_exchange_weak( t, p + n ) )
+                        return p;
+                    p = align( t, a );
+                }
+            }
+            addBlock( b, n, a );
+        }
+    }
+
+    void deallocate( void*, size_t ) { }
+
+    /*
+     * Free every block. Nothing allocated from the Arena may be used after,
+     * and nothing may allocate from it during.
+     */
+    void release() {
+        for( Block* b = head.exchange( nullptr ); b; ) {
+            Block* prev = b->prev;
+            b->~Block();
+            ::operator delete( static_cast<void*>(b) );
+            b = prev;
+        }
+    }
+
+    /* The Arena with_arena has installed on this thread, if any. */
+    static Arena*& current() {
+        static thread_local Arena* a = nullptr;
+        return a;
+    }
+};
+
+/*
+ * ArenaAllocator X -- a standard allocator that takes from an Arena.
+ *
+ * Default-constructed, it uses Arena::current(), or the global heap if
+ * there is none. Remap and dupTo give map's result, filter's, and so on,
+ * the same allocator as their input, and List.h default-constructs them, so
+ * inside with_arena a whole pipeline over an ArenaVector allocates from the
+ * arena. Like std::pmr's allocators, it stays with its container: a copy
+ * made outside with_arena goes on the heap, which is how a result leaves
+ * the arena before the arena goes away.
+ */
+template< class X >
+struct ArenaAllocator {
+    using value_type = X;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap            = std::false_type;
+
+    Arena* arena;
+
+    ArenaAllocator() : arena( Arena::current() ) { }
+    explicit ArenaAllocator( Arena& a ) : arena( &a ) { }
+
+    template< class Y >
+    ArenaAllocator( const ArenaAllocator<Y>& o ) : arena( o.arena ) { }
+
+    X* allocate( size_t n ) {
+        return static_cast<X*> (
+            arena ? arena->allocate( n * sizeof(X), alignof(X) )
+                  : ::operator new( n * sizeof(X) )
+        );
+    }
+
+    void deallocate( X* p, size_t n ) {
+        if( arena )
+            arena->deallocate( p, n * sizeof(X) );
+        else
+            ::operator delete( p );
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+
+    template< class Y > struct rebind { using other = ArenaAllocator<Y>; };
+};
+
+template< class X, class Y >
+bool operator == ( const ArenaAllocator<X>& a, const ArenaAllocator<Y>& b ) {
+    return a.arena == b.arena;
+}
+
+template< class X, class Y >
+bool operator != ( const ArenaAllocator<X>& a, const ArenaAllocator<Y>& b ) {
+    return not (a == b);
+}
+
+/* A vector whose storage comes from the current arena. */
+template< class X >
+using ArenaVector = std::vector< X, ArenaAllocator<X> >;
+
+/*
+ * with_arena a f -- call f with a as the current arena on this thread,
+ * and return what it does. Whatever f returns that holds arena memory must
+ * not outlive a.
+ *
+ * Threads don't share the current arena: the Pool's workers allocate from
+ * the heap, unless they're handed a container that already uses a.
+ */
+template< class F >
+auto with_arena( Arena& a, F&& f ) -> decltype( f() ) {
+    struct Restore {
+        Arena* old;
+        ~Restore() { Arena::current() = old; }
+    } restore{ Arena::current() };
+
+    Arena::current() = &a;
+    return f();
+}
+
+#ifdef PURE_HAS_PMR
+/* An Arena as a std::pmr::memory_resource, for polymorphic_allocator. */
+class ArenaResource : public std::pmr::memory_resource {
+    Arena& arena;
+
+    void* do_allocate( size_t n, size_t a ) override {
+        return arena.allocate( n, a );
+    }
+
+    void do_deallocate( void* p, size_t n, size_t ) override {
+        arena.deallocate( p, n );
+    }
+
+    bool do_is_equal( const std::pmr::memory_resource& o )
+        const noexcept override
+    {
+        return this == &o;
+    }
+
+  public:
+    explicit ArenaResource( Arena& a ) : arena( a ) { }
+};
+#endif
+
+} // namespace pure
@@ -0,0 +1,580 @@
+#pragma once
+
+#include "Pure.h"
+#include "Monoid.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace pure {
+
+/*
+ * Arbitrary-precision integers.
+ *
+ * A number is kept as its magnitude in base 2^64, least significant limb
+ * first, plus a sign. Adding or multiplying by a machine word touches each
+ * limb once, in place, rather than each decimal digit; decimal digits are
+ * only worked out when asked for, nine at a time.
+ */
+namespace bigint {
+
+using Limb  = std::uint64_t;
+using Limbs = std::vector<Limb>;
+
+/* Below this many limbs, schoolbook multiplication beats Karatsuba. */
+constexpr size_t KARATSUBA = 32;
+
+/* The most a base-10^9 chunk can hold, and its base. */
+constexpr unsigned int CHUNK_DIGITS = 9;
+constexpr std::uint32_t CHUNK = 1000000000;
+
+/* a*b + c + d, which always fits in two limbs; returns the low one. */
+inline Limb mulAdd( Limb a, Limb b, Limb c, Limb d, Limb& hi ) {
+#if defined(__SIZEOF_INT128__)
+    using Wide = unsigned __int128;
+    const Wide w = Wide(a) * b + c + d;
+    hi = Limb( w >> 64 );
+    return Limb( w );
+#else
+    const Limb M = 0xFFFFFFFF;
+    const Limb p00 = (a & M) * (b & M), p01 = (a & M) * (b >> 32);
+    const Limb p10 = (a >> 32) * (b & M), p11 = (a >> 32) * (b >> 32);
+    const Limb mid = (p00 >> 32) + (p01 & M) + (p10 & M);
+    Limb lo = (mid << 32) | (p00 & M);
+    hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    lo += c;
+    hi += lo < c;
+    lo += d;
+    hi += lo < d;
+    return lo;
+#endif
+}
+
+/* Drop the leading zero limbs. */
+inline void trim( Limbs& x ) {
+    while( not x.empty() and x.back() == 0 )
+        x.pop_back();
+}
+
+/* compare |a| |b| -- negative, zero or positive. */
+inline int compare( const Limbs& a, const Limbs& b ) {
+    if( a.size() != b.size() )
+        return a.size() < b.size() ? -1 : 1;
+    for( size_t i = a.size(); i-- > 0; )
+        if( a[i] != b[i] )
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+/* r += a * 2^(64*shift), growing r as needed. */
+inline void addShifted( Limbs& r, const Limb* a, size_t n, size_t shift ) {
+    if( r.size() < shift + n )
+        r.resize( shift + n, 0 );
+
+    Limb carry = 0;
+    for( size_t i = 0; i < n; i++ ) {
+        Limb& x = r[shift + i];
+        x += carry;
+        carry = x < carry;
+        x += a[i];
+        carry += x < a[i];
+    }
+    for( size_t i = shift + n; carry; i++ ) {
+        if( i == r.size() )
+            r.push_back( 0 );
+        carry = ++r[i] == 0;
+    }
+}
+
+/* r -= a, where |r| >= |a|. */
+inline void subtract( Limbs& r, const Limb* a, size_t n ) {
+    Limb borrow = 0;
+    size_t i = 0;
+    for( ; i < n; i++ ) {
+        const Limb x = r[i];
+        const Limb y = a[i] + borrow;
+        borrow = (y < borrow) | (x < y);
+        r[i] = x - y;
+    }
+    for( ; borrow; i++ )
+        borrow = r[i]-- == 0;
+    trim( r );
+}
+
+/* r *= m, then += c. */
+inline void mulSmall( Limbs& r, Limb m, Limb c = 0 ) {
+    for( Limb& x : r )
+        x = mulAdd( x, m, c, 0, c );
+    if( c )
+        r.push_back( c );
+    trim( r );
+}
+
+/* r /= d; returns the remainder. */
+inline std::uint32_t divSmall( std::vector<std::uint32_t>& r,
+                               std::uint32_t d )
+{
+    std::uint64_t rem = 0;
+    for( size_t i = r.size(); i-- > 0; ) {
+        const std::uint64_t x = (rem << 32) | r[i];
+        r[i] = std::uint32_t( x / d );
+        rem = x % d;
+    }
+    while( not r.empty() and r.back() == 0 )
+        r.pop_back();
+    return std::uint32_t( rem );
+}
+
+inline Limbs schoolbook( const Limb* a, size_t na, const Limb* b, size_t nb ) {
+    Limbs r( na + nb, 0 );
+    for( size_t i = 0; i < na; i++ ) {
+        Limb carry = 0;
+        for( size_t j = 0; j < nb; j++ )
+            r[i+j] = mulAdd( a[i], b[j], r[i+j], carry, carry );
+        r[i+nb] = carry;
+    }
+    trim( r );
+    return r;
+}
+
+/*
+ * multiply a b -- by Karatsuba's method: with B = 2^(64m),
+ *      (a1 B + a0)(b1 B + b0) = z2 B^2 + z1 B + z0
+ * where z0 = a0 b0, z2 = a1 b1 and z1 = (a0 + a1)(b0 + b1) - z0 - z2,
+ * making three half-size products where schoolbook would make four.
+ * O(n^1.585) instead of O(n^2).
+ */
+inline Limbs multiply( const Limb* a, size_t na, const Limb* b, size_t nb ) {
+    if( na > nb ) {
+        std::swap( a, b );
+        std::swap( na, nb );
+    }
+    if( na < KARATSUBA )
+        return schoolbook( a, na, b, nb );
+
+    Limbs r;
+    if( 2 * na <= nb ) {
+        // Lopsided: multiply a by each na-limb slice of b.
+        r.reserve( na + nb );
+        for( size_t i = 0; i < nb; i += na ) {
+            const Limbs p = multiply( a, na, b + i, std::min( na, nb - i ) );
+            addShifted( r, p.data(), p.size(), i );
+        }
+        trim( r );
+        return r;
+    }
+
+    const size_t m = nb / 2; // So a1 and b1 are both non-empty.
+    const Limbs z0 = multiply( a, m, b, m );
+    const Limbs z2 = multiply( a + m, na - m, b + m, nb - m );
+
+    Limbs sa( a, a + m ), sb( b, b + m );
+    addShifted( sa, a + m, na - m, 0 );
+    addShifted( sb, b + m, nb - m, 0 );
+    Limbs z1 = multiply( sa.data(), sa.size(), sb.data(), sb.size() );
+    subtract( z1, z0.data(), z0.size() );
+    subtract( z1, z2.data(), z2.size() );
+
+    r.reserve( na + nb );
+    r.assign( z0.begin(), z0.end() );
+    addShifted( r, z1.data(), z1.size(), m );
+    addShifted( r, z2.data(), z2.size(), 2 * m );
+    trim( r );
+    return r;
+}
+
+/*
+ * The magnitude in base 10^9, least significant chunk first. Each pass
+ * divides the whole number by 10^9 in 32-bit halves, a 64-by-32-bit division
+ * the compiler turns into a multiply, and peels off nine digits.
+ */
+inline std::vector<std::uint32_t> toChunks( const Limbs& x ) {
+    std::vector<std::uint32_t> halves;
+    halves.reserve( 2 * x.size() );
+    for( Limb l : x ) {
+        halves.push_back( std::uint32_t( l ) );
+        halves.push_back( std::uint32_t( l >> 32 ) );
+    }
+    while( not halves.empty() and halves.back() == 0 )
+        halves.pop_back();
+
+    std::vector<std::uint32_t> chunks;
+    chunks.reserve( halves.size() * 32 / 29 + 1 ); // log2(10^9) > 29.
+    while( not halves.empty() )
+        chunks.push_back( divSmall( halves, CHUNK ) );
+    return chunks;
+}
+
+/* 10^i, for i < CHUNK_DIGITS. */
+inline std::uint32_t pow10( unsigned int i ) {
+    static const std::uint32_t ps[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+    };
+    return ps[i];
+}
+
+/* The number of decimal digits in c. */
+inline unsigned int digitCount( std::uint32_t c ) {
+    unsigned int n = 1;
+    while( n < CHUNK_DIGITS and c >= pow10(n) )
+        n++;
+    return n;
+}
+
+/*
+ * Digits -- the decimal digits of a number's magnitude, most significant
+ * first, as a random-access sequence of unsigned ints. (0 has the one digit.)
+ * Only the base-10^9 chunks are stored; each digit is divided out of its
+ * chunk when read. Copies share the chunks.
+ */
+class Digits {
+    std::shared_ptr< const std::vector<std::uint32_t> > chunks;
+    unsigned int lead = 1; // Digits in the most significant chunk.
+    size_t n = 1;
+
+  public:
+    using value_type      = unsigned int;
+    using reference       = unsigned int;
+    using const_reference = unsigned int;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    explicit Digits( std::vector<std::uint32_t> cs )
+        : chunks( std::make_shared< const std::vector<std::uint32_t> >(
+                      std::move(cs) ) )
+    {
+        if( not chunks->empty() ) {
+            lead = digitCount( chunks->back() );
+            n = lead + CHUNK_DIGITS * ( chunks->size() - 1 );
+        }
+    }
+
+    size_t size()  const { return n; }
+    bool   empty() const { return false; }
+
+    unsigned int operator[] ( size_t i ) const {
+        if( chunks->empty() )
+            return 0;
+
+        // Which chunk, from the top, and which digit of it, from the right.
+        size_t c = 0;
+        unsigned int place = lead - 1 - unsigned( i );
+        if( i >= lead ) {
+            c = 1 + (i - lead) / CHUNK_DIGITS;
+            place = CHUNK_DIGITS - 1 - unsigned( (i - lead) % CHUNK_DIGITS );
+        }
+        const std::uint32_t x = (*chunks)[ chunks->size() - 1 - c ];
+        return x / pow10( place ) % 10;
+    }
+
+    unsigned int front() const { return (*this)[0]; }
+    unsigned int back()  const { return (*this)[n-1]; }
+
+    struct const_iterator
+        : std::iterator< std::random_access_iterator_tag, unsigned int,
+                         std::ptrdiff_t, const unsigned int*, unsigned int >
+    {
+        const Digits* ds = nullptr;
+        size_t i = 0;
+
+        const_iterator() { }
+        const_iterator( const Digits* ds, size_t i ) : ds(ds), i(i) { }
+
+        unsigned int operator* () const { return (*ds)[i]; }
+        unsigned int operator[] ( std::ptrdiff_t k ) const {
+            return (*ds)[i + k];
+        }
+
+        const_iterator& operator++ () { i++; return *this; }
+        const_iterator& operator-- () { i--; return *this; }
+        const_iterator operator++ (int) { auto c = *this; i++; return c; }
+        const_iterator operator-- (int) { auto c = *this; i--; return c; }
+
+        const_iterator& operator+= ( std::ptrdiff_t k ) {
+            i += k;
+            return *this;
+        }
+        const_iterator& operator-= ( std::ptrdiff_t k ) {
+            i -= k;
+            return *this;
+        }
+
+        const_iterator operator+ ( std::ptrdiff_t k ) const {
+            auto c = *this;
+            return c += k;
+        }
+        const_iterator operator- ( std::ptrdiff_t k ) const {
+            auto c = *this;
+            return c -= k;
+        }
+        std::ptrdiff_t operator- ( const const_iterator& o ) const {
+            return std::ptrdiff_t(i) - std::ptrdiff_t(o.i);
+        }
+
+        bool operator== ( const const_iterator& o ) const { return i == o.i; }
+        bool operator!= ( const const_iterator& o ) const { return i != o.i; }
+        bool operator<  ( const const_iterator& o ) const { return i <  o.i; }
+        bool operator>  ( const const_iterator& o ) const { return i >  o.i; }
+        bool operator<= ( const const_iterator& o ) const { return i <= o.i; }
+        bool operator>= ( const const_iterator& o ) const { return i >= o.i; }
+    };
+
+    using iterator = const_iterator;
+
+    const_iterator begin() const { return const_iterator( this, 0 ); }
+    const_iterator end()   const { return const_iterator( this, n ); }
+};
+
+} // namespace bigint
+
+/*
+ * BigInt -- an integer of any size.
+ *
+ *      x + y, x - y     O(n), in place for +=, -=
+ *      x * y            O(n^1.585) by Karatsuba past 32 limbs (~600
+ *                       decimal digits), schoolbook below; O(n) and in
+ *                       place when y fits in a limb
+ *      str, digits      O(n^2), but nine digits per pass
+ *
+ * Any integer type converts, so 2 * x and x + 1 work; so do list::sum,
+ * list::product and foldl(Mult(),...) over sequences of BigInts.
+ */
+class BigInt {
+  public:
+    using Limb = bigint::Limb;
+
+  private:
+    bigint::Limbs mag; // |x|, least significant limb first; empty if zero.
+    bool neg = false;
+
+    void fixZero() {
+        if( mag.empty() )
+            neg = false;
+    }
+
+    /* |x| += |y| if same is true, else |x| -= |y|, keeping x's sign right. */
+    void addMag( const BigInt& y, bool same ) {
+        if( &y == this ) {
+            addMag( BigInt( y ), same );
+            return;
+        }
+
+        if( same ) {
+            bigint::addShifted( mag, y.mag.data(), y.mag.size(), 0 );
+        } else if( bigint::compare( mag, y.mag ) >= 0 ) {
+            bigint::subtract( mag, y.mag.data(), y.mag.size() );
+        } else {
+            bigint::Limbs r = y.mag;
+            bigint::subtract( r, mag.data(), mag.size() );
+            mag.swap( r );
+            neg = not neg;
+        }
+        fixZero();
+    }
+
+  public:
+    BigInt() { }
+
+    template< class I, class = typename std::enable_if <
+        std::is_integral<I>::value
+    >::type >
+    BigInt( I x ) : neg( x < 0 ) {
+        // Negate as unsigned so the least value of a signed type works.
+        unsigned long long u = (unsigned long long) x;
+        if( neg )
+            u = 0 - u;
+        if( u )
+            mag.push_back( u );
+    }
+
+    /* From decimal, with an optional leading '-'. */
+    explicit BigInt( const std::string& s ) {
+        size_t i = s.size() and s[0] == '-';
+        size_t first = (s.size() - i) % bigint::CHUNK_DIGITS;
+        if( first == 0 )
+            first = bigint::CHUNK_DIGITS;
+        for( size_t len = first; i < s.size();
+             i += len, len = bigint::CHUNK_DIGITS )
+        {
+            std::uint32_t c = 0;
+            for( size_t j = i; j < i + len; j++ )
+                c = c * 10 + std::uint32_t( s[j] - '0' );
+            bigint::mulSmall( mag, len == bigint::CHUNK_DIGITS ?
+                bigint::CHUNK : bigint::pow10( unsigned(len) ), c );
+        }
+        neg = s.size() and s[0] == '-';
+        fixZero();
+    }
+
+    bool negative() const { return neg; }
+
+    /* |x| in base 2^64, least significant limb first. */
+    const bigint::Limbs& limbs() const { return mag; }
+
+    BigInt operator- () const {
+        BigInt r = *this;
+        r.neg = not neg;
+        r.fixZero();
+        return r;
+    }
+
+    BigInt& operator+= ( const BigInt& y ) {
+        addMag( y, neg == y.neg );
+        return *this;
+    }
+
+    BigInt& operator-= ( const BigInt& y ) {
+        addMag( y, neg != y.neg );
+        return *this;
+    }
+
+    BigInt& operator*= ( const BigInt& y ) {
+        const bool sign = neg != y.neg;
+        if( y.mag.size() <= 1 ) {
+            bigint::mulSmall( mag, y.mag.empty() ? 0 : y.mag[0] );
+        } else if( mag.size() == 1 ) {
+            const Limb m = mag[0];
+            mag = y.mag;
+            bigint::mulSmall( mag, m );
+        } else {
+            mag = bigint::multiply( mag.data(), mag.size(),
+                                    y.mag.data(), y.mag.size() );
+        }
+        neg = sign;
+        fixZero();
+        return *this;
+    }
+
+    friend BigInt operator + ( BigInt x, const BigInt& y ) { return x += y; }
+    friend BigInt operator - ( BigInt x, const BigInt& y ) { return x -= y; }
+    friend BigInt operator * ( BigInt x, const BigInt& y ) { return x *= y; }
+
+    /* pow x n = x^n, by repeated squaring. */
+    friend BigInt pow( BigInt x, unsigned int n ) {
+        BigInt r = 1;
+        for( ; n; n >>= 1 ) {
+            if( n & 1 )
+                r *= x;
+            if( n > 1 )
+                x *= x;
+        }
+        return r;
+    }
+
+    friend bool operator == ( const BigInt& x, const BigInt& y ) {
+        return x.neg == y.neg and x.mag == y.mag;
+    }
+
+    friend bool operator < ( const BigInt& x, const BigInt& y ) {
+        if( x.neg != y.neg )
+            return x.neg;
+        const int c = bigint::compare( x.mag, y.mag );
+        return x.neg ? c > 0 : c < 0;
+    }
+
+    friend bool operator != ( const BigInt& x, const BigInt& y ) {
+        return not (x == y);
+    }
+    friend bool operator >  ( const BigInt& x, const BigInt& y ) {
+        return y < x;
+    }
+    friend bool operator <= ( const BigInt& x, const BigInt& y ) {
+        return not (y < x);
+    }
+    friend bool operator >= ( const BigInt& x, const BigInt& y ) {
+        return not (x < y);
+    }
+
+    /* digits x -- the decimal digits of |x|, most significant first. */
+    bigint::Digits digits() const {
+        return bigint::Digits( bigint::toChunks( mag ) );
+    }
+
+    /* show x */
+    std::string str() const {
+        const std::vector<std::uint32_t> cs = bigint::toChunks( mag );
+        std::string s = neg ? "-" : "";
+        s += std::to_string( cs.empty() ? 0 : cs.back() );
+        for( size_t i = cs.size(); i-- > 1; ) {
+            const std::string c = std::to_string( cs[i-1] );
+            s.append( bigint::CHUNK_DIGITS - c.size(), '0' ).append( c );
+        }
+        return s;
+    }
+};
+
+inline std::ostream& operator << ( std::ostream& os, const BigInt& x ) {
+    return os << x.str();
+}
+
+namespace monoid {
+
+/*
+ * BigSum, BigProduct -- like Sum and Product, for BigInts. Where int's would
+ * overflow, these just grow.
+ */
+struct BigSum {
+    BigInt sum = 0;
+
+    BigSum() { }
+    BigSum( BigInt x ) : sum( std::move(x) ) { }
+
+    operator const BigInt& () const { return sum; }
+};
+
+inline BigSum operator + ( BigSum a, const BigSum& b ) {
+    a.sum += b.sum;
+    return a;
+}
+
+template<> struct Monoid< BigSum > {
+    template< class _ >
+    static BigSum mempty() { return BigSum(); }
+
+    static BigSum mappend( BigSum a, const BigSum& b ) {
+        return std::move(a) + b;
+    }
+
+    template< class S >
+    static BigSum mconcat( const S& s ) {
+        return list::foldl( mappend, BigSum(), s );
+    }
+};
+
+struct BigProduct {
+    BigInt prod = 1;
+
+    BigProduct() { }
+    BigProduct( BigInt x ) : prod( std::move(x) ) { }
+
+    operator const BigInt& () const { return prod; }
+};
+
+inline BigProduct operator * ( BigProduct a, const BigProduct& b ) {
+    a.prod *= b.prod;
+    return a;
+}
+
+template<> struct Monoid< BigProduct > {
+    template< class _ >
+    static BigProduct mempty() { return BigProduct(); }
+
+    static BigProduct mappend( BigProduct a, const BigProduct& b ) {
+        return std::move(a) * b;
+    }
+
+    template< class S >
+    static BigProduct mconcat( const S& s ) {
+        return list::foldl( mappend, BigProduct(), s );
+    }
+};
+
+} // namespace monoid
+
+} // namespace pure
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "List.h"
+
+#include <tuple>
+#include <type_traits>
+
+namespace pure {
+
+namespace list {
+
+/*
+ * List comprehensions.
+ *
+ * In the list monad,
+ *      xs >>= (\x -> ys x >>= (\y -> guard (p x y) >> [f x y]))
+ * builds every (ys x) and every [f x y] as its own vector, then appends each
+ * to the last. A comprehension states the same thing,
+ *      [ f x y | x <- xs, y <- ys x, p x y ]
+ *      comprehend( f, from(xs), bindWith(ys), when(p) )
+ * and runs it as one loop nest that writes each f x y straight into the
+ * result.
+ *
+ * Each stage sees every variable bound so far, in order: bindWith(g) calls
+ * g(x,...) and draws from what it returns, when(p) skips unless p(x,...), and
+ * f is called with all of them. If every stage is a from, the result's size
+ * is known up front and reserved once.
+ *
+ * Like a lazy view, a stage holds an lvalue sequence by reference.
+ */
+
+/* x <- xs */
+template< class S > struct From {
+    S s;
+};
+
+/* y <- g x ... */
+template< class G > struct BindWith {
+    G g;
+};
+
+/* guard (p x ...) */
+template< class P > struct When {
+    P p;
+};
+
+template< class S >
+constexpr From<S> from( S&& s ) {
+    return From<S>{ forward<S>(s) };
+}
+
+template< class G >
+constexpr BindWith<Decay<G>> bindWith( G&& g ) {
+    return BindWith<Decay<G>>{ forward<G>(g) };
+}
+
+template< class P >
+constexpr When<Decay<P>> when( P&& p ) {
+    return When<Decay<P>>{ forward<P>(p) };
+}
+
+/* The type of f's result, given the stages: f applied to each bound x. */
+template< class F, class XS, class ...Stage > struct ComprehensionResult;
+
+template< class F, class ...X >
+struct ComprehensionResult< F, std::tuple<X...> > {
+    using type = Result< const F&, const X&... >;
+};
+
+template< class F, class ...X, class S, class ...Stage >
+struct ComprehensionResult< F, std::tuple<X...>, From<S>, Stage... >
+    : ComprehensionResult< F, std::tuple<X...,SeqVal<S>>, Stage... >
+{
+};
+
+template< class F, class ...X, class G, class ...Stage >
+struct ComprehensionResult< F, std::tuple<X...>, BindWith<G>, Stage... >
+    : ComprehensionResult <
+        F, std::tuple< X..., SeqVal<Result<const G&,const X&...>> >, Stage...
+    >
+{
+};
+
+template< class F, class ...X, class P, class ...Stage >
+struct ComprehensionResult< F, std::tuple<X...>, When<P>, Stage... >
+    : ComprehensionResult< F, std::tuple<X...>, Stage... >
+{
+};
+
+/* The number of results, if every stage is a from; otherwise, zero. */
+constexpr size_t comprehensionSize() { return 1; }
+
+template< class S, class ...Stage >
+size_t comprehensionSize( const From<S>& s, const Stage& ...st ) {
+    return length( s.s ) * comprehensionSize( st... );
+}
+
+template< class Stage, class ...Rest >
+constexpr size_t comprehensionSize( const Stage&, const Rest& ... ) {
+    return 0;
+}
+
+/* The loop nest: one level per stage, and f at the bottom. */
+template< class Out, class F, class ...Stage > struct ComprehensionLoop {
+    static constexpr size_t N = sizeof...(Stage);
+
+    template< size_t I >
+    using At = std::integral_constant< size_t, I >;
+
+    Out& out;
+    const F& f;
+    const std::tuple<Stage...>& stages;
+
+    template< class ...X >
+    void go( At<N>, const X& ...x ) {
+        cons_( out, f(x...) );
+    }
+
+    template< size_t I, class ...X >
+    void go( At<I>, const X& ...x ) {
+        step( std::get<I>(stages), At<I+1>(), x... );
+    }
+
+    template< class S, class Next, class ...X >
+    void step( const From<S>& s, Next next, const X& ...x ) {
+        for( const auto& y : s.s )
+            go( next, x..., y );
+    }
+
+    template< class G, class Next, class ...X >
+    void step( const BindWith<G>& b, Next next, const X& ...x ) {
+        for( const auto& y : b.g(x...) )
+            go( next, x..., y );
+    }
+
+    template< class P, class Next, class ...X >
+    void step( const When<P>& w, Next next, const X& ...x ) {
+        if( w.p(x...) )
+            go( next, x... );
+    }
+};
+
+/*
+ * comprehend f stages... = [ f x... | stages... ]
+ * comprehend<S> puts the results in an S (std::vector by default).
+ */
+template< template<class...> class S = std::vector, class F, class ...Stage,
+          class R = S< typename ComprehensionResult <
+              Decay<F>, std::tuple<>, Stage...
+          >::type > >
+R comprehend( F&& f, Stage ...stage ) {
+    R r;
+    reserve_( r, comprehensionSize(stage...) );
+
+    const std::tuple<Stage...> stages( move(stage)... );
+    ComprehensionLoop< R, Decay<F>, Stage... >{ r, f, stages }.go (
+        std::integral_constant<size_t,0>()
+    );
+    return r;
+}
+
+} // namespace list
+
+} // namespace pure
@@ -1,7 +1,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace pure {
 
@@ -23,6 +27,166 @@ constexpr M Nothing() {
     return nullptr;
 }
 
+/*
+ * Maybe X -- Just x or Nothing, stored in place.
+ * Just and Nothing, above, make a std::unique_ptr, so each one allocates.
+ * A Maybe holds its value inline with a flag, so making, copying or binding
+ * one never touches the heap. Like a pointer, it tests true when it holds a
+ * value and *m gets the value, so category::cat files it as a maybe_type and
+ * every Maybe instance (fmap, >>=, <*>, <|>, <>, foldr...) works on it. Those
+ * instances give back a Maybe when given one.
+ *
+ *      auto m = Inline(2);              -- Just 2
+ *      auto n = Nothing<int,Maybe<int>>();
+ */
+template< class X > class Maybe {
+    union {
+        char none;
+        X x;
+    };
+    bool just;
+
+  public:
+    using value_type   = X;
+    using element_type = X;
+
+    Maybe() : none(), just(false) { }
+    Maybe( std::nullptr_t ) : none(), just(false) { }
+
+    explicit Maybe( const X& v ) : x(v), just(true) { }
+    explicit Maybe( X&& v ) : x(std::move(v)), just(true) { }
+
+    Maybe( const Maybe& m ) : none(), just(m.just) {
+        if( just )
+            new (&x) X( m.x );
+    }
+
+    Maybe( Maybe&& m )
+        noexcept( std::is_nothrow_move_constructible<X>::value )
+        : none(), just(m.just)
+    {
+        if( just )
+            new (&x) X( std::move(m.x) );
+    }
+
+    ~Maybe() { reset(); }
+
+    Maybe& operator= ( const Maybe& m ) {
+        if( just and m.just )
+            x = m.x;
+        else if( m.just )
+            emplace( m.x );
+        else
+            reset();
+        return *this;
+    }
+
+    Maybe& operator= ( Maybe&& m )
+        noexcept( std::is_nothrow_move_constructible<X>::value and
+                  std::is_nothrow_move_assignable<X>::value )
+    {
+        if( just and m.just )
+            x = std::move( m.x );
+        else if( m.just )
+            emplace( std::move(m.x) );
+        else
+            reset();
+        return *this;
+    }
+
+    Maybe& operator= ( std::nullptr_t ) {
+        reset();
+        return *this;
+    }
+
+    template< class ...Y >
+    void emplace( Y&& ...y ) {
+        reset();
+        new (&x) X( std::forward<Y>(y)... );
+        just = true;
+    }
+
+    void reset() {
+        if( just )
+            x.~X();
+        just = false;
+    }
+
+    explicit operator bool () const { return just; }
+
+    X&       operator* () &       { return x; }
+    const X& operator* () const & { return x; }
+    X&&      operator* () &&      { return std::move(x); }
+
+    X*       operator-> ()       { return &x; }
+    const X* operator-> () const { return &x; }
+};
+
+template< class X >
+bool operator == ( const Maybe<X>& a, const Maybe<X>& b ) {
+    return a and b ? *a == *b : bool(a) == bool(b);
+}
+
+template< class X >
+bool operator != ( const Maybe<X>& a, const Maybe<X>& b ) {
+    return not (a == b);
+}
+
+/* Nothing < Just x */
+template< class X >
+bool operator < ( const Maybe<X>& a, const Maybe<X>& b ) {
+    return a and b ? *a < *b : bool(b) and not a;
+}
+
+template< class X >
+bool operator == ( const Maybe<X>& a, std::nullptr_t ) { return not a; }
+
+template< class X >
+bool operator != ( const Maybe<X>& a, std::nullptr_t ) { return bool(a); }
+
+template< template<class...> class M >
+struct ConstructVal {
+    template< class X, class _X = Decay<X> >
+    M<_X> operator () ( X&& x ) const {
+        return M<_X>( std::forward<X>(x) );
+    }
+};
+
+/* Inline x -- Just x, as a Maybe. */
+constexpr auto Inline = ConstructVal<Maybe>();
+
+/*
+ * The Maybe instances build their results with the same kind of maybe they
+ * were given: JustLike<M,X> is that kind holding an X, and justLike<M>(x)
+ * makes one. A Maybe gives a Maybe; a pointer gives a std::unique_ptr, like
+ * Just.
+ */
+template< class M > struct MaybeKind {
+    template< class X > using type = std::unique_ptr<X>;
+
+    template< class X, class _X = Decay<X> >
+    static std::unique_ptr<_X> just( X&& x ) {
+        return Just( std::forward<X>(x) );
+    }
+};
+
+template< class Y > struct MaybeKind< Maybe<Y> > {
+    template< class X > using type = Maybe<X>;
+
+    template< class X, class _X = Decay<X> >
+    static Maybe<_X> just( X&& x ) {
+        return Maybe<_X>( std::forward<X>(x) );
+    }
+};
+
+template< class M, class X >
+using JustLike = typename MaybeKind<Decay<M>>::template type<Decay<X>>;
+
+template< class M, class X >
+JustLike<M,X> justLike( X&& x ) {
+    return MaybeKind<Decay<M>>::just( std::forward<X>(x) );
+}
+
 template< class T > struct ReturnNothing {
     constexpr auto operator () () -> decltype( Nothing<T>() ) {
         return Nothing<T>();
@@ -36,16 +200,16 @@ constexpr R maybe( R&& nothingVal, F&& f, P&& m ) {
              : forward<R>( nothingVal );
 }
 
-/* Either a b : Left a | Right b */
+/*
+ * Either a b : Left a | Right b
+ * Stored in place: a union of the two, and a tag saying which it holds.
+ */
 template< class L, class R >
 struct Either
 {
     typedef L left_type;
     typedef R right_type;
 
-    std::unique_ptr<left_type> left;
-    std::unique_ptr<right_type> right;
-
     // TODO: Make these type constructors, not types.
     struct Left { 
         left_type value;
@@ -57,11 +221,112 @@ struct Either
         constexpr Right( right_type value ) : value(move(value)) { }
     };
 
-    template< class X >
-    explicit constexpr Either( X&& x )  
-        : left(  new left_type (move(x.value)) ) { }
-    explicit constexpr Either( Right x ) 
-        : right( new right_type(move(x.value)) ) { }
+  private:
+    union {
+        left_type  l;
+        right_type r;
+    };
+    bool isRight;
+
+    // False only if building a new value, in assignment, threw. Then this
+    // holds neither side, and left() and right() are both null.
+    bool holds;
+
+    // Both leave isRight and holds alone until the value is built.
+    void construct( const Either& e ) {
+        if( not e.holds )
+            return;
+        if( e.isRight )
+            new (&r) right_type( e.r );
+        else
+            new (&l) left_type( e.l );
+        isRight = e.isRight;
+        holds = true;
+    }
+
+    void construct( Either&& e ) {
+        if( not e.holds )
+            return;
+        if( e.isRight )
+            new (&r) right_type( move(e.r) );
+        else
+            new (&l) left_type( move(e.l) );
+        isRight = e.isRight;
+        holds = true;
+    }
+
+    void destroy() {
+        if( not holds )
+            return;
+        if( isRight )
+            r.~right_type();
+        else
+            l.~left_type();
+        holds = false;
+    }
+
+    bool sameSide( const Either& e ) const {
+        return holds and e.holds and isRight == e.isRight;
+    }
+
+  public:
+    explicit Either( Left x )
+        : l( move(x.value) ), isRight(false), holds(true) { }
+    explicit Either( Right x )
+        : r( move(x.value) ), isRight(true), holds(true) { }
+
+    Either( const Either& e ) : isRight(e.isRight), holds(false) {
+        construct( e );
+    }
+
+    Either( Either&& e )
+        noexcept( std::is_nothrow_move_constructible<L>::value and
+                  std::is_nothrow_move_constructible<R>::value )
+        : isRight(e.isRight), holds(false)
+    {
+        construct( move(e) );
+    }
+
+    ~Either() { destroy(); }
+
+    Either& operator= ( const Either& e ) {
+        if( sameSide(e) and isRight )
+            r = e.r;
+        else if( sameSide(e) )
+            l = e.l;
+        else if( this != &e ) {
+            destroy();
+            construct( e );
+        }
+        return *this;
+    }
+
+    Either& operator= ( Either&& e )
+        noexcept( std::is_nothrow_move_constructible<L>::value and
+                  std::is_nothrow_move_constructible<R>::value and
+                  std::is_nothrow_move_assignable<L>::value and
+                  std::is_nothrow_move_assignable<R>::value )
+    {
+        if( sameSide(e) and isRight )
+            r = move( e.r );
+        else if( sameSide(e) )
+            l = move( e.l );
+        else if( this != &e ) {
+            destroy();
+            construct( move(e) );
+        }
+        return *this;
+    }
+
+    /* The value on either side, or nullptr. */
+    left_type*  left() { return holds and not isRight ? &l : nullptr; }
+    right_type* right() { return holds and isRight ? &r : nullptr; }
+    const left_type* left() const {
+        return holds and not isRight ? &l : nullptr;
+    }
+    const right_type* right() const {
+        return holds and isRight ? &r : nullptr;
+    }
 };
 
 /* 
@@ -80,24 +345,40 @@ constexpr E Right( R x ) { return E( typename E::Right(move(x)) ); }
 /* either (a->c) (b->c) (Either a b) -> c */
 template< class F, class G, class L, class R >
 constexpr auto either( F&& f, G&& g, const Either<L,R>& e )
-    -> decltype( declval<F>()(*e.right) )
+    -> decltype( declval<F>()(*e.right()) )
+{
+    return e.right() ? forward<F>(f)(*e.right()) : forward<G>(g)(*e.left());
+}
+
+template< class F, class G, class L, class R >
+constexpr auto either( F&& f, G&& g, Either<L,R>&& e )
+    -> decltype( declval<F>()(declval<R>()) )
 {
-    return e.right ? forward<F>(f)(*e.right) : forward<G>(g)(*e.left);
+    return e.right() ? forward<F>(f)( move(*e.right()) )
+                     : forward<G>(g)( move(*e.left()) );
 }
 
 /*
  * Right f * Right x = Right (f x)
  * _       * _       = Left _
- *
- * TODO: Replace this with an instantiation in Applicative.
  */
 template< class L, class F, class T, 
           class Ret = decltype( declval<F>()(declval<T>()) ) >
-constexpr Either<L,Ret> operator* ( const Either<L,F>& a, 
+constexpr Either<L,Ret> operator* ( const Either<L,F>& a,
                                     const Either<L,T>& b )
 {
-    return a.right and b.right ? Right<L>( (*a.right)(*b.right) )
-        : a.left ? Left<Ret>( *a.left ) : Left<Ret>( *b.left );
+    return a.right() and b.right() ? Right<L>( (*a.right())(*b.right()) )
+        : a.left() ? Left<Ret>( *a.left() ) : Left<Ret>( *b.left() );
+}
+
+template< class L, class F, class T, 
+          class Ret = decltype( declval<F>()(declval<T>()) ) >
+constexpr Either<L,Ret> operator* ( Either<L,F>&& a, Either<L,T>&& b )
+{
+    return a.right() and b.right()
+        ? Right<L>( move(*a.right())( move(*b.right()) ) )
+        : a.left() ? Left<Ret>( move(*a.left()) )
+                   : Left<Ret>( move(*b.left()) );
 }
 
 } // namespace data
@@ -0,0 +1,371 @@
+#pragma once
+
+#include "List.h"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+namespace pure {
+
+/*
+ * FlatSet X -- a set kept as a sorted std::vector, without duplicates.
+ *
+ * Inserting into the middle of a vector moves everything after, so adding n
+ * elements one at a time costs O(n^2). Instead, insert appends to an unsorted
+ * tail, and the next read sorts the tail, merges it in and drops duplicates:
+ * a run of insertions costs one O(k log k + n) pass. An element larger than
+ * every other just goes on the end.
+ *
+ * Since reading may settle the tail, a FlatSet that has been inserted into
+ * must not be read from two threads at once until something has read it.
+ *
+ * set::ordered's operators use the algorithms below on FlatSets.
+ */
+template< class X, class Compare = std::less<X> >
+class FlatSet {
+    mutable std::vector<X> xs;
+    mutable size_t sorted = 0; // xs[0,sorted) is settled; the rest is not.
+    Compare cmp;
+
+    /* Sort the tail, merge it in and drop the duplicates. */
+    void settle() const {
+        if( sorted == xs.size() )
+            return;
+
+        const auto mid = xs.begin() + sorted;
+        std::sort( mid, xs.end(), cmp );
+        std::inplace_merge( xs.begin(), mid, xs.end(), cmp );
+
+        const Compare& c = cmp;
+        xs.erase( std::unique( xs.begin(), xs.end(),
+                               [&]( const X& a, const X& b ) {
+                                   return not c( a, b );
+                               } ),
+                  xs.end() );
+        sorted = xs.size();
+    }
+
+  public:
+    using value_type      = X;
+    using key_type        = X;
+    using key_compare     = Compare;
+    using reference       = const X&;
+    using const_reference = const X&;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_iterator  = typename std::vector<X>::const_iterator;
+    using iterator        = const_iterator;
+
+    /* For constructing from a vector that is already sorted and unique. */
+    struct SortedUnique { };
+
+    FlatSet() { }
+
+    FlatSet( std::initializer_list<X> l ) : xs( l ) { }
+
+    template< class I >
+    FlatSet( I b, I e ) : xs( b, e ) { }
+
+    explicit FlatSet( std::vector<X> v ) : xs( std::move(v) ) { }
+
+    FlatSet( SortedUnique, std::vector<X> v )
+        : xs( std::move(v) ), sorted( xs.size() )
+    {
+    }
+
+    const Compare& key_comp() const { return cmp; }
+
+    size_t size()  const { settle(); return xs.size(); }
+    bool   empty() const { return xs.empty(); }
+
+    const_iterator begin()  const { settle(); return xs.cbegin(); }
+    const_iterator end()    const { settle(); return xs.cend(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend()   const { return end(); }
+
+    const X* data() const { settle(); return xs.data(); }
+
+    const X& front() const { return *begin(); }
+    const X& back()  const { settle(); return xs.back(); }
+
+    /* The elements, in order. */
+    const std::vector<X>& vector() const { settle(); return xs; }
+
+    void reserve( size_t n ) { xs.reserve( n ); }
+    void clear() { xs.clear(); sorted = 0; }
+
+    const_iterator lower_bound( const X& x ) const {
+        return std::lower_bound( begin(), end(), x, cmp );
+    }
+
+    const_iterator find( const X& x ) const {
+        auto it = lower_bound( x );
+        return it != end() and not cmp( x, *it ) ? it : end();
+    }
+
+    bool contains( const X& x ) const { return find(x) != end(); }
+    size_t count( const X& x ) const { return contains(x); }
+
+    /* Add x; it is sorted in on the next read. */
+    void insert( X x ) {
+        if( sorted == xs.size() and ( xs.empty() or cmp(xs.back(), x) ) )
+            sorted++;
+        xs.push_back( std::move(x) );
+    }
+
+    /* Add [b,e), sorting them in once. */
+    template< class I >
+    void insert( I b, I e ) {
+        xs.insert( xs.end(), b, e );
+    }
+
+    /* So that tailInserter, cons and the like can build a FlatSet. */
+    void push_back( X x ) { insert( std::move(x) ); }
+
+    const_iterator erase( const_iterator it ) {
+        settle();
+        auto r = xs.erase( it );
+        sorted = xs.size();
+        return r;
+    }
+
+    const_iterator erase( const_iterator b, const_iterator e ) {
+        settle();
+        auto r = xs.erase( b, e );
+        sorted = xs.size();
+        return r;
+    }
+
+    size_t erase( const X& x ) {
+        auto it = find( x );
+        if( it == end() )
+            return 0;
+        erase( it );
+        return 1;
+    }
+
+    void swap( FlatSet& o ) {
+        xs.swap( o.xs );
+        std::swap( sorted, o.sorted );
+        std::swap( cmp, o.cmp );
+    }
+
+    /* The storage, for algorithms that rebuild a set in place. */
+    std::vector<X>& settled() { settle(); return xs; }
+};
+
+template< class X, class C >
+bool operator == ( const FlatSet<X,C>& a, const FlatSet<X,C>& b ) {
+    return a.vector() == b.vector();
+}
+
+template< class X, class C >
+bool operator != ( const FlatSet<X,C>& a, const FlatSet<X,C>& b ) {
+    return not (a == b);
+}
+
+namespace flat {
+
+/*
+ * When one set is this many times larger than the other, the algorithms
+ * below search the larger for each element of the smaller, rather than
+ * walking both.
+ */
+constexpr size_t GALLOP = 32;
+
+/*
+ * gallop lo hi x -- the first place in [lo,hi) not less than x, by
+ * exponential search: lo+1, lo+2, lo+4... then a binary search of the last
+ * step. O(log d) for an answer d places on, so a walk through the larger set
+ * costs O(m log(n/m)) rather than O(n).
+ */
+template< class I, class X, class C >
+I gallop( I lo, I hi, const X& x, const C& less ) {
+    size_t step = 1;
+    while( size_t(hi - lo) > step and less( lo[step], x ) ) {
+        lo += step;
+        step *= 2;
+    }
+    return std::lower_bound( lo, size_t(hi - lo) > step ? lo + step : hi,
+                             x, less );
+}
+
+/* The same, searching down from hi. */
+template< class I, class X, class C >
+I gallopDown( I lo, I hi, const X& x, const C& less ) {
+    size_t step = 1;
+    while( size_t(hi - lo) > step
+           and not less( hi[-std::ptrdiff_t(step)], x ) )
+    {
+        hi -= step;
+        step *= 2;
+    }
+    return std::lower_bound( size_t(hi - lo) > step ? hi - step : lo, hi,
+                             x, less );
+}
+
+/* Is Y one element of a FlatSet X, rather than a sequence of them? */
+template< class Y, class X, class R >
+using EElement = typename std::enable_if <
+    std::is_convertible<Y,X>::value, R
+>::type;
+
+template< class Y, class X, class R >
+using XElement = typename std::enable_if <
+    not std::is_convertible<Y,X>::value, R
+>::type;
+
+/* Can the SIMD kernel intersect these? */
+template< class X, class C >
+struct IsSimdKey : std::integral_constant < bool,
+    std::is_integral<X>::value and ( sizeof(X) == 4 or sizeof(X) == 8 )
+    and std::is_same< C, std::less<X> >::value
+> { };
+
+template< class X, class C >
+using ESimdKey = typename std::enable_if< IsSimdKey<X,C>::value >::type;
+
+template< class X, class C >
+using XSimdKey = typename std::enable_if< not IsSimdKey<X,C>::value >::type;
+
+/* Walk both; for keys, by the SIMD kernel. */
+template< class X, class C >
+XSimdKey<X,C> intersectLinear( const std::vector<X>& a,
+                               const std::vector<X>& b, std::vector<X>& r,
+                               const C& less )
+{
+    std::set_intersection( a.begin(), a.end(), b.begin(), b.end(),
+                           std::back_inserter(r), less );
+}
+
+template< class X, class C >
+ESimdKey<X,C> intersectLinear( const std::vector<X>& a,
+                               const std::vector<X>& b, std::vector<X>& r,
+                               const C& )
+{
+    r.resize( std::min( a.size(), b.size() ) + simd::Block<X>::value );
+    r.resize( simd::intersect( a.data(), a.size(), b.data(), b.size(),
+                               r.data() ) );
+}
+
+/* xs intersected with ys */
+template< class X, class C >
+FlatSet<X,C> intersect( const FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    const std::vector<X>& a = xs.vector();
+    const std::vector<X>& b = ys.vector();
+    const std::vector<X>& small = a.size() <= b.size() ? a : b;
+    const std::vector<X>& large = a.size() <= b.size() ? b : a;
+    const C& less = xs.key_comp();
+
+    std::vector<X> r;
+    if( large.size() > GALLOP * small.size() ) {
+        r.reserve( small.size() );
+        auto it = large.begin();
+        for( const X& x : small ) {
+            it = gallop( it, large.end(), x, less );
+            if( it == large.end() )
+                break;
+            if( not less( x, *it ) )
+                r.push_back( *it++ );
+        }
+    } else {
+        intersectLinear( a, b, r, less );
+    }
+    return FlatSet<X,C>( typename FlatSet<X,C>::SortedUnique(), move(r) );
+}
+
+/* Every x from xs not in ys. */
+template< class X, class C >
+FlatSet<X,C> difference( const FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    const std::vector<X>& a = xs.vector();
+    const std::vector<X>& b = ys.vector();
+    const C& less = xs.key_comp();
+
+    std::vector<X> r;
+    if( a.size() > GALLOP * b.size() ) {
+        // Copy the runs of xs between the ys.
+        r.reserve( a.size() );
+        auto it = a.begin();
+        for( const X& y : b ) {
+            auto at = gallop( it, a.end(), y, less );
+            r.insert( r.end(), it, at );
+            it = at;
+            if( it != a.end() and not less( y, *it ) )
+                ++it;
+        }
+        r.insert( r.end(), it, a.end() );
+    } else if( b.size() > GALLOP * a.size() ) {
+        // Look up each x in ys.
+        auto it = b.begin();
+        for( const X& x : a ) {
+            it = gallop( it, b.end(), x, less );
+            if( it == b.end() or less( x, *it ) )
+                r.push_back( x );
+        }
+    } else {
+        std::set_difference( a.begin(), a.end(), b.begin(), b.end(),
+                             std::back_inserter(r), less );
+    }
+    return FlatSet<X,C>( typename FlatSet<X,C>::SortedUnique(), move(r) );
+}
+
+/* xs is a subset of ys */
+template< class X, class C >
+bool subset( const FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    const std::vector<X>& a = xs.vector();
+    const std::vector<X>& b = ys.vector();
+    const C& less = xs.key_comp();
+
+    if( a.size() > b.size() )
+        return false;
+    if( b.size() <= GALLOP * a.size() )
+        return std::includes( b.begin(), b.end(), a.begin(), a.end(), less );
+
+    auto it = b.begin();
+    for( const X& x : a ) {
+        it = gallop( it, b.end(), x, less );
+        if( it == b.end() or less( x, *it ) )
+            return false;
+    }
+    return true;
+}
+
+/*
+ * xs |= ys, in xs's own storage: grow it once, then merge from the back,
+ * moving each run of xs past the ys above it in one step. Galloping down
+ * finds the runs, so a few ys into a large xs cost O(m log n) comparisons.
+ */
+template< class X, class C >
+void unite( FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    if( &xs == &ys )
+        return;
+
+    std::vector<X>& a = xs.settled();
+    const std::vector<X>& b = ys.vector();
+    const C& less = xs.key_comp();
+
+    size_t i = a.size(), w = a.size() + b.size();
+    a.resize( w );
+    for( size_t j = b.size(); j-- > 0; ) {
+        const X& y = b[j];
+        const size_t at = size_t (
+            gallopDown( a.begin(), a.begin() + i, y, less ) - a.begin()
+        );
+        std::move_backward( a.begin() + at, a.begin() + i, a.begin() + w );
+        w -= i - at;
+        i = at;
+        // a[w] is the least of what's placed so far, and not less than y.
+        if( w == a.size() or less( y, a[w] ) )
+            a[--w] = y;
+    }
+    // a[0,i) hasn't moved; close the gap left by duplicates.
+    if( w > i )
+        a.erase( std::move( a.begin() + w, a.end(), a.begin() + i ), a.end() );
+}
+
+} // namespace flat
+
+} // namespace pure
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pure {
+
+/*
+ * A temporary hash table for set algebra on sequences.
+ *
+ * list::difference, intersect, sunion and nub, and the set::generic
+ * operators, look up every element of one sequence in the other. Done with
+ * elem, that's O(n*m). When the element type has a std::hash, they instead
+ * put one side into a Table and probe it, for O(n+m).
+ *
+ * A Table doesn't copy the elements; it holds pointers into the sequences it
+ * was built from, which must outlive it and not reallocate. It uses open
+ * addressing with linear probing, so a lookup touches one contiguous run of
+ * slots, and keeps a count with each key (for difference, which removes one
+ * x per y).
+ */
+namespace hash {
+
+template< class X > struct IsHashableImpl {
+    template< class _X > static auto f( const _X& x )
+        -> decltype( std::hash<_X>()(x), std::true_type() );
+    template< class _X > static std::false_type f( ... );
+
+    using type = decltype( f<X>( std::declval<const X&>() ) );
+};
+
+/* Does std::hash<X> exist? */
+template< class X >
+using IsHashable = typename IsHashableImpl<X>::type;
+
+template< class X, class H = std::hash<X> > struct Table {
+    struct Slot {
+        const X* x;
+        size_t n;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask;
+    size_t size = 0;
+
+    /* A table that can hold n keys without growing. */
+    explicit Table( size_t n ) {
+        size_t cap = 16;
+        while( cap < 2 * n )
+            cap *= 2;
+        slots.assign( cap, Slot{ nullptr, 0 } );
+        mask = cap - 1;
+    }
+
+    // std::hash is often the identity on integers, so mix the bits before
+    // masking: sequential or strided IDs would otherwise pile up.
+    size_t index( const X& x ) const {
+        unsigned long long h = H()( x );
+        h *= 0x9E3779B97F4A7C15ull;
+        return size_t( h ^ (h >> 32) ) & mask;
+    }
+
+    /* The slot holding x, or the empty slot where x would go. */
+    Slot& slot( const X& x ) {
+        size_t i = index( x );
+        while( slots[i].x and not (*slots[i].x == x) )
+            i = (i + 1) & mask;
+        return slots[i];
+    }
+
+    void grow() {
+        std::vector<Slot> old( slots.size() * 2, Slot{ nullptr, 0 } );
+        old.swap( slots );
+        mask = slots.size() - 1;
+        for( const Slot& s : old )
+            if( s.x )
+                slot( *s.x ) = s;
+    }
+
+    /*
+     * Count x once more. x must live as long as the table.
+     * Returns true if x was not already there.
+     */
+    bool insert( const X& x ) {
+        if( 2 * (size + 1) > slots.size() )
+            grow();
+        Slot& s = slot( x );
+        s.n++;
+        if( s.x )
+            return false;
+        s.x = &x;
+        size++;
+        return true;
+    }
+
+    /* The count of x, or zero. */
+    size_t count( const X& x ) {
+        return slot( x ).n;
+    }
+
+    /* Set the count of x to zero. */
+    void remove( const X& x ) {
+        slot( x ).n = 0;
+    }
+
+    /* Count x once less, if it's there. Returns whether it was. */
+    bool take( const X& x ) {
+        Slot& s = slot( x );
+        if( s.n == 0 )
+            return false;
+        s.n--;
+        return true;
+    }
+};
+
+/* A table of every element of s. */
+template< class X, class S >
+Table<X> table( const S& s ) {
+    Table<X> t( std::distance( std::begin(s), std::end(s) ) );
+    for( const X& x : s )
+        t.insert( x );
+    return t;
+}
+
+} // namespace hash
+
+} // namespace pure
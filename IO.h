@@ -6,6 +6,18 @@
 
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define PURE_IO_MMAP 1
+#   include <cstdio>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#endif
 
 namespace pure {
 namespace io {
@@ -28,6 +40,183 @@ C fileContents( Stream& s ) {
     return C( s );
 }
 
+#ifdef PURE_IO_MMAP
+/*
+ * mappedContents path -- the bytes of a file, as a sequence of const char.
+ *
+ * Contents reads through an istream_iterator: one formatted, locale-aware
+ * extraction per element, and only once. A MappedContents maps the whole
+ * file into memory instead; its iterators are plain const char*, so it is
+ * random-access, can be read any number of times, and nothing gets copied
+ * until something asks for a copy (dup gives a std::string).
+ *
+ * Copies share the mapping, which stays until the last one is gone. The
+ * kernel is told the file will be read in order, so it reads ahead.
+ *
+ * Throws std::system_error if the file can't be opened or mapped.
+ */
+class MappedFile {
+    const char* p = nullptr;
+    size_t n = 0;
+
+  public:
+    // Opened through stdio: <unistd.h> would bring ::fork and ::dup into
+    // the global namespace, where they clash with tpl::fork and list::dup.
+    explicit MappedFile( const std::string& path ) {
+        std::FILE* f = std::fopen( path.c_str(), "rb" );
+        if( not f )
+            throw std::system_error( errno, std::generic_category(), path );
+
+        struct stat st;
+        int err = ::fstat( fileno(f), &st ) < 0 ? errno : 0;
+
+        // mmap refuses a length of zero.
+        n = err ? 0 : st.st_size;
+        if( n > 0 ) {
+            void* m = ::mmap( nullptr, n, PROT_READ, MAP_PRIVATE,
+                              fileno(f), 0 );
+            if( m == MAP_FAILED )
+                err = errno;
+            else {
+                ::madvise( m, n, MADV_SEQUENTIAL );
+                p = static_cast<const char*>( m );
+            }
+        }
+
+        std::fclose( f );
+        if( err )
+            throw std::system_error( err, std::generic_category(), path );
+    }
+
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator = ( const MappedFile& ) = delete;
+
+    ~MappedFile() {
+        if( p )
+            ::munmap( const_cast<char*>(p), n );
+    }
+
+    const char* data() const { return p; }
+    size_t      size() const { return n; }
+};
+
+struct MappedContents {
+    using value_type      = char;
+    using reference       = const char&;
+    using const_reference = const char&;
+    using iterator        = const char*;
+    using const_iterator  = const char*;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    std::shared_ptr<const MappedFile> file;
+
+    explicit MappedContents( const std::string& path )
+        : file( std::make_shared<MappedFile>(path) ) { }
+
+    const char* begin() const { return file->data(); }
+    const char* end()   const { return file->data() + file->size(); }
+
+    size_t size()  const { return file->size(); }
+    bool   empty() const { return size() == 0; }
+
+    const char& operator[] ( size_t i ) const { return begin()[i]; }
+};
+
+inline MappedContents mappedContents( const std::string& path ) {
+    return MappedContents( path );
+}
+
+/* A copy of the file's bytes, for functions that build a new sequence. */
+inline std::string dup( const MappedContents& m ) {
+    return std::string( m.begin(), m.end() );
+}
+
+/*
+ * The pieces of a MappedContents between delimiters, each a Range of
+ * const char* into the mapping. They split the same way as lazy::lines and
+ * lazy::words (runs of delimiters count as one), but find each delimiter
+ * with a plain scan of bytes.
+ */
+template< class Delim > struct PiecesView {
+    using value_type = list::Range< std::string, const char* >;
+    using reference  = value_type;
+
+    MappedContents m;
+
+    explicit PiecesView( MappedContents m ) : m( std::move(m) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        const char *b, *m, *e; // The piece is [b,m).
+        bool done;
+
+        iterator( const char* b, const char* e )
+            : b(b), m( Delim::find(b,e) ), e(e), done(false) { }
+
+        explicit iterator( const char* e ) : b(e), m(e), e(e), done(true) { }
+
+        reference operator* () const { return reference( b, m ); }
+
+        iterator& operator++ () {
+            b = m;
+            while( b != e and Delim::is(*b) )
+                ++b;
+            if( b == e )
+                done = true;
+            else
+                m = Delim::find( b, e );
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const {
+            return done == o.done and (done or b == o.b);
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const { return iterator( m.begin(), m.end() ); }
+    iterator end()   const { return iterator( m.end() ); }
+};
+
+struct Newline {
+    static bool is( char c ) { return c == '\n'; }
+
+    static const char* find( const char* b, const char* e ) {
+        if( b == e )
+            return e;
+        auto p = static_cast<const char*>( std::memchr(b, '\n', e - b) );
+        return p ? p : e;
+    }
+};
+
+/* Whitespace in the "C" locale, whatever the current one is. */
+struct Space {
+    static bool is( char c ) { return c == ' ' or (c >= '\t' and c <= '\r'); }
+
+    static const char* find( const char* b, const char* e ) {
+        while( b != e and not is(*b) )
+            ++b;
+        return b;
+    }
+};
+
+/* lines m -- the pieces of m between '\n's. */
+inline PiecesView<Newline> lines( MappedContents m ) {
+    return PiecesView<Newline>( std::move(m) );
+}
+
+/* words m -- the pieces of m between whitespace. */
+inline PiecesView<Space> words( MappedContents m ) {
+    return PiecesView<Space>( std::move(m) );
+}
+#endif // PURE_IO_MMAP
+
 } // namespace io
 } // namespace pure
 
@@ -0,0 +1,928 @@
+#pragma once
+
+#include "List.h"
+
+#include <iterator>
+#include <memory>
+
+namespace pure {
+
+namespace list {
+
+/*
+ * Lazy views.
+ *
+ * Every function in List.h builds a whole new sequence, so
+ *      take( 10, filter(p, map(f,xs)) )
+ * maps all of xs, filters all of that, and only then throws away everything
+ * but the first ten. The views here compute an element only when an iterator
+ * reaches it and allocate nothing, so the same chain runs in one pass and
+ * stops at the tenth match. Nothing gets stored until it is asked for:
+ *      dupTo<std::vector>( take(10, filter(p, map(f,xs))) )
+ *
+ * A view holds its sequence the way closure holds its arguments: an lvalue
+ * by reference and an rvalue (like another view) by value. Like range(s), a
+ * view of an lvalue must not outlive it.
+ *
+ * To use these in place of the strict versions, import the namespace:
+ *      using namespace pure::list::lazy;
+ */
+namespace lazy {
+
+/* map f xs -- f applied to each x as it is read. */
+template< class F, class S > struct MapView {
+    using base_iterator = SeqIter<const S>;
+    using value_type    = Result< const F&, SeqRef<const S> >;
+    using reference     = value_type;
+
+    F f;
+    S s;
+
+    template< class _F, class _S >
+    constexpr MapView( _F&& f, _S&& s )
+        : f( forward<_F>(f) ), s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator it;
+        const F* f;
+
+        iterator( base_iterator it, const F* f ) : it(it), f(f) { }
+
+        reference operator* () { return (*f)( *it ); }
+
+        iterator& operator++ () { ++it; return *this; }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const { return it == o.it; }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const { return iterator( pure::begin(s), &f ); }
+    iterator end()   const { return iterator( pure::end(s),   &f ); }
+};
+
+/* filter p xs -- skips each x where not (p x) as it is read. */
+template< class P, class S > struct FilterView {
+    using base_iterator = SeqIter<const S>;
+    using reference     = SeqRef<const S>;
+    using value_type    = Decay<reference>;
+
+    P p;
+    S s;
+
+    template< class _P, class _S >
+    constexpr FilterView( _P&& p, _S&& s )
+        : p( forward<_P>(p) ), s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator it, e;
+        const P* p;
+
+        iterator( base_iterator it, base_iterator e, const P* p )
+            : it(it), e(e), p(p)
+        {
+            satisfy();
+        }
+
+        // The end. Never read from it: an infinite sequence's end can be
+        // dereferenced, which would grow it.
+        iterator( base_iterator e, const P* p ) : it(e), e(e), p(p) { }
+
+        // Move to the first x, starting from it, where p(x).
+        void satisfy() {
+            while( it != e and not (*p)(*it) )
+                ++it;
+        }
+
+        reference operator* () { return *it; }
+
+        iterator& operator++ () { ++it; satisfy(); return *this; }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const { return it == o.it; }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const {
+        return iterator( pure::begin(s), pure::end(s), &p );
+    }
+    iterator end() const { return iterator( pure::end(s), &p ); }
+};
+
+/*
+ * take n xs -- at most n elements of xs.
+ * Works on infinite sequences (iterate, memorize) since it stops counting at
+ * n, and never reads passed the nth element.
+ */
+template< class S > struct TakeView {
+    using base_iterator = SeqIter<const S>;
+    using reference     = SeqRef<const S>;
+    using value_type    = Decay<reference>;
+
+    size_t n;
+    S s;
+
+    template< class _S >
+    constexpr TakeView( size_t n, _S&& s ) : n(n), s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator it;
+        size_t n; // Elements left.
+
+        iterator( base_iterator it, size_t n ) : it(it), n(n) { }
+
+        reference operator* () { return *it; }
+
+        iterator& operator++ () {
+            // Don't advance past the last element taken; for a filter, that
+            // would mean searching for an element we don't want.
+            if( --n )
+                ++it;
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const {
+            return n == o.n or it == o.it;
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const { return iterator( pure::begin(s), n ); }
+    iterator end()   const { return iterator( pure::end(s),   0 ); }
+};
+
+/* takeWhile p xs -- every x from the start of xs until not (p x). */
+template< class P, class S > struct TakeWhileView {
+    using base_iterator = SeqIter<const S>;
+    using reference     = SeqRef<const S>;
+    using value_type    = Decay<reference>;
+
+    P p;
+    S s;
+
+    template< class _P, class _S >
+    constexpr TakeWhileView( _P&& p, _S&& s )
+        : p( forward<_P>(p) ), s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator it, e;
+        const P* p;
+        bool done;
+
+        iterator( base_iterator it, base_iterator e, const P* p )
+            : it(it), e(e), p(p), done( it == e or not (*p)(*it) ) { }
+
+        iterator( base_iterator e, const P* p )
+            : it(e), e(e), p(p), done(true) { }
+
+        reference operator* () { return *it; }
+
+        iterator& operator++ () {
+            ++it;
+            done = it == e or not (*p)(*it);
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        // Infinite sequences never compare equal to their end, so track
+        // whether p has failed instead of relying on it == e.
+        bool operator== ( const iterator& o ) const {
+            return done == o.done and (done or it == o.it);
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const {
+        return iterator( pure::begin(s), pure::end(s), &p );
+    }
+    iterator end() const { return iterator( pure::end(s), &p ); }
+};
+
+/* drop n xs -- xs without its first n elements. */
+template< class S > struct DropView {
+    using iterator   = SeqIter<const S>;
+    using reference  = SeqRef<const S>;
+    using value_type = Decay<reference>;
+
+    size_t n;
+    S s;
+
+    template< class _S >
+    constexpr DropView( size_t n, _S&& s ) : n(n), s( forward<_S>(s) ) { }
+
+    iterator begin() const {
+        auto it = pure::begin(s);
+        const auto e = pure::end(s);
+        for( size_t i = 0; i < n and it != e; i++ )
+            ++it;
+        return it;
+    }
+    iterator end() const { return pure::end(s); }
+};
+
+/* dropWhile p xs -- xs starting from the first x where not (p x). */
+template< class P, class S > struct DropWhileView {
+    using iterator   = SeqIter<const S>;
+    using reference  = SeqRef<const S>;
+    using value_type = Decay<reference>;
+
+    P p;
+    S s;
+
+    template< class _P, class _S >
+    constexpr DropWhileView( _P&& p, _S&& s )
+        : p( forward<_P>(p) ), s( forward<_S>(s) ) { }
+
+    iterator begin() const {
+        auto it = pure::begin(s);
+        const auto e = pure::end(s);
+        while( it != e and p(*it) )
+            ++it;
+        return it;
+    }
+    iterator end() const { return pure::end(s); }
+};
+
+/*
+ * concatMap f xs -- each element of each (f x).
+ * Only the (f x) the iterator is reading, and the one before it, exist at a
+ * time. Copies of an iterator share them, so a reference read from one,
+ * even by *it++, stays good until they have all gone a whole (f x) further.
+ */
+template< class F, class S > struct ConcatMapView {
+    using base_iterator  = SeqIter<const S>;
+    using inner_type     = Result< const F&, SeqRef<const S> >;
+    using inner_iterator = SeqIter<inner_type>;
+    using value_type     = SeqVal<inner_type>;
+    using reference      = SeqRef<inner_type>;
+
+    F f;
+    S s;
+
+    template< class _F, class _S >
+    constexpr ConcatMapView( _F&& f, _S&& s )
+        : f( forward<_F>(f) ), s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator it, e;
+        const F* f;
+        std::shared_ptr<inner_type> inner, prev;
+        inner_iterator ii, ie;
+        size_t k = 0; // Position in inner.
+
+        iterator( base_iterator it, base_iterator e, const F* f )
+            : it(it), e(e), f(f)
+        {
+            load();
+        }
+
+        iterator( base_iterator e, const F* f ) : it(e), e(e), f(f) { }
+
+        // Find the next x such that (f x) is not null.
+        void load() {
+            for( ; it != e; ++it ) {
+                inner = std::make_shared<inner_type>( (*f)(*it) );
+                ii = pure::begin( *inner );
+                ie = pure::end( *inner );
+                if( ii != ie )
+                    return;
+            }
+            inner.reset();
+        }
+
+        reference operator* () { return *ii; }
+
+        iterator& operator++ () {
+            k++;
+            if( ++ii == ie ) {
+                k = 0;
+                ++it;
+                prev = std::move( inner );
+                load();
+            }
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const {
+            return it == o.it and k == o.k;
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const {
+        return iterator( pure::begin(s), pure::end(s), &f );
+    }
+    iterator end() const { return iterator( pure::end(s), &f ); }
+};
+
+/*
+ * splitBy p s -- each piece of s between runs of elements where (p x), as a
+ * Range over s. Like list::splitBy_wrap, but finds each piece only when the
+ * iterator reaches it, so splitting a large buffer needs no memory.
+ */
+template< class P, class S > struct SplitView {
+    using base_iterator = SeqIter<const S>;
+    using value_type    = Range< Decay<S>, base_iterator >;
+    using reference     = value_type;
+
+    P p;
+    S s;
+
+    template< class _P, class _S >
+    constexpr SplitView( _P&& p, _S&& s )
+        : p( forward<_P>(p) ), s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator b, m, e; // The piece is [b,m).
+        const P* p;
+        bool done;
+
+        iterator( base_iterator b, base_iterator e, const P* p )
+            : b(b), m( std::find_if(b,e,*p) ), e(e), p(p), done(false) { }
+
+        iterator( base_iterator e, const P* p )
+            : b(e), m(e), e(e), p(p), done(true) { }
+
+        reference operator* () { return reference( b, m ); }
+
+        iterator& operator++ () {
+            b = std::find_if_not( m, e, *p );
+            if( b == e )
+                done = true;
+            else
+                m = std::find_if( b, e, *p );
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        // An empty s still has one (empty) piece, so b == e does not mean
+        // the end.
+        bool operator== ( const iterator& o ) const {
+            return done == o.done and (done or b == o.b);
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const {
+        return iterator( pure::begin(s), pure::end(s), &p );
+    }
+    iterator end() const { return iterator( pure::end(s), &p ); }
+};
+
+/*
+ * inits xs -- [], [x0], [x0,x1], ... each prefix of xs but xs itself, as a
+ * Range over xs. Unlike inits_wrap, it never holds more than one Range, and
+ * works on infinite sequences.
+ */
+template< class S > struct InitsView {
+    using base_iterator = SeqIter<const S>;
+    using value_type    = Range< Decay<S>, base_iterator >;
+    using reference     = value_type;
+
+    S s;
+
+    template< class _S >
+    constexpr InitsView( _S&& s ) : s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator b, it; // The prefix is [b,it).
+
+        iterator( base_iterator b, base_iterator it ) : b(b), it(it) { }
+
+        reference operator* () { return reference( b, it ); }
+
+        iterator& operator++ () { ++it; return *this; }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const { return it == o.it; }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const {
+        return iterator( pure::begin(s), pure::begin(s) );
+    }
+    iterator end() const { return iterator( pure::begin(s), pure::end(s) ); }
+};
+
+/*
+ * tails xs -- [], [xn], [xn-1,xn], ... each suffix of xs, shortest first, as
+ * a Range over xs. xs must have bidirectional iterators.
+ */
+template< class S > struct TailsView {
+    using base_iterator = SeqIter<const S>;
+    using value_type    = Range< Decay<S>, base_iterator >;
+    using reference     = value_type;
+
+    S s;
+
+    template< class _S >
+    constexpr TailsView( _S&& s ) : s( forward<_S>(s) ) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        base_iterator b, it, e; // The suffix is [it,e).
+        bool done;
+
+        iterator( base_iterator b, base_iterator e, bool done )
+            : b(b), it(e), e(e), done(done) { }
+
+        reference operator* () { return reference( it, e ); }
+
+        iterator& operator++ () {
+            if( it == b )
+                done = true;
+            else
+                --it;
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        // The first suffix and the end both start at e.
+        bool operator== ( const iterator& o ) const {
+            return done == o.done and (done or it == o.it);
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const {
+        return iterator( pure::begin(s), pure::end(s), null(s) );
+    }
+    iterator end() const {
+        return iterator( pure::begin(s), pure::end(s), true );
+    }
+};
+
+/*
+ * permutations xs -- each ordering of xs, stepping with std::next_permutation
+ * from xs itself, through the last ordering, back around to the first, and
+ * stopping before xs comes up again (the same order as list::permutations).
+ *
+ * Only one permutation exists at a time, inside the iterator; reading the
+ * next one rearranges it in place. Copy it to keep it.
+ */
+template< class S > struct PermutationView {
+    using reference  = const S&;
+    using value_type = S;
+
+    // Steps permute only [fixed,end), from `from` until reaching `to`.
+    S from, to;
+    size_t fixed;
+
+    PermutationView( S s ) : from(s), to(move(s)), fixed(0) { }
+
+    PermutationView( S from, S to, size_t fixed )
+        : from(move(from)), to(move(to)), fixed(fixed) { }
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        S cur;
+        const S* to;
+        size_t fixed;
+
+        // If to comes after cur, every step may reach it; otherwise, only
+        // the steps after wrapping around from the last ordering can.
+        bool check, done;
+
+        iterator( const PermutationView& v )
+            : cur(v.from), to(&v.to), fixed(v.fixed),
+              check( v.from < v.to ), done(false) { }
+
+        iterator() : to(nullptr), fixed(0), check(false), done(true) { }
+
+        reference operator* () { return cur; }
+
+        iterator& operator++ () {
+            if( not std::next_permutation( std::next(pure::begin(cur),fixed),
+                                           pure::end(cur) ) )
+                check = true;
+            done = check and cur == *to;
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        bool operator== ( const iterator& o ) const {
+            return done == o.done and (done or cur == o.cur);
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+    };
+
+    iterator begin() const { return iterator( *this ); }
+    iterator end()   const { return iterator(); }
+
+    /*
+     * split k -- at least k views (when xs has that many distinct prefixes)
+     * that together produce the same permutations, in the same order. Each
+     * piece keeps a prefix of xs fixed and permutes the rest. A view that
+     * stops short of a full cycle (like the first and last pieces) doesn't
+     * split.
+     */
+    std::vector<PermutationView> split( size_t k ) const {
+        std::vector<PermutationView> r;
+        const size_t n = length( from ) - fixed;
+        if( n < 2 or not (from == to) ) {
+            r.push_back( *this );
+            return r;
+        }
+
+        // Fix the fewest elements that make k prefixes.
+        size_t d = 1, prefixes = n;
+        while( prefixes < k and d < n - 1 )
+            prefixes *= n - d++;
+        d += fixed;
+
+        // The first ordering with each prefix, in order: a prefix followed by
+        // the rest, sorted.
+        std::vector<S> firsts;
+        S b = from;
+        std::sort( std::next(pure::begin(b),fixed), pure::end(b) );
+        do {
+            firsts.push_back( b );
+            std::reverse( std::next(pure::begin(b),d), pure::end(b) );
+        } while( std::next_permutation( std::next(pure::begin(b),fixed),
+                                        pure::end(b) ) );
+
+        // Start with the piece holding from, and end with it too if from
+        // isn't the first of its prefix.
+        auto samePrefix = [&]( const S& x ) {
+            return std::equal( pure::begin(x), std::next(pure::begin(x),d),
+                               pure::begin(from) );
+        };
+        size_t i = std::find_if( firsts.begin(), firsts.end(), samePrefix )
+                   - firsts.begin();
+
+        r.emplace_back( from, firsts[i], d );
+        for( size_t j = 1; j < firsts.size(); j++ ) {
+            const S& f = firsts[ (i + j) % firsts.size() ];
+            r.emplace_back( f, f, d );
+        }
+        if( not (firsts[i] == from) )
+            r.emplace_back( firsts[i], from, d );
+        return r;
+    }
+};
+
+/*
+ * cartesian xs ys -- every (x,y), x-major: the kth pair is
+ *      ( xs !! (k / length ys), ys !! (k mod length ys) )
+ * Only xs and ys are stored, so filter, find, any, foldl and the rest can
+ * read |xs|*|ys| pairs without building them. Each pair holds references
+ * into xs and ys, where they give references.
+ *
+ * If both have random access, so does the view: it+n and it[n] find (i,j)
+ * by one division. A view covers a run of xs's rows, which slice narrows;
+ * parallel::foldMap splits it that way.
+ */
+template< class XS, class YS > struct ProductView {
+    using x_iterator = SeqIter<const XS>;
+    using y_iterator = SeqIter<const YS>;
+    using value_type = std::pair< SeqVal<XS>, SeqVal<YS> >;
+    using reference  = std::pair< SeqRef<const XS>, SeqRef<const YS> >;
+
+    using Slice = ProductView< const Decay<XS>&, const Decay<YS>& >;
+
+    XS xs;
+    YS ys;
+    size_t lo, hi; // The rows of xs viewed, [lo,hi).
+    size_t ny;     // length ys
+
+    template< class _XS, class _YS >
+    ProductView( _XS&& xs, _YS&& ys )
+        : xs( forward<_XS>(xs) ), ys( forward<_YS>(ys) ),
+          lo(0), hi( length(this->xs) ), ny( length(this->ys) ) { }
+
+    template< class _XS, class _YS >
+    ProductView( _XS&& xs, _YS&& ys, size_t lo, size_t hi, size_t ny )
+        : xs( forward<_XS>(xs) ), ys( forward<_YS>(ys) ),
+          lo(lo), hi(hi), ny(ny) { }
+
+    using category = typename std::conditional <
+        std::is_base_of< std::random_access_iterator_tag,
+                         ItCata<x_iterator> >::value and
+        std::is_base_of< std::random_access_iterator_tag,
+                         ItCata<y_iterator> >::value,
+        std::random_access_iterator_tag, std::forward_iterator_tag
+    >::type;
+
+    struct iterator
+        : std::iterator< category, value_type,
+                         std::ptrdiff_t, const value_type*, reference >
+    {
+        x_iterator xi;
+        y_iterator yi, yb;
+        size_t i, j, ny; // At row i, column j.
+
+        iterator() { }
+        iterator( x_iterator xi, y_iterator yb, size_t i, size_t ny )
+            : xi(xi), yi(yb), yb(yb), i(i), j(0), ny(ny) { }
+
+        reference operator* () const { return reference( *xi, *yi ); }
+        reference operator[] ( std::ptrdiff_t n ) const {
+            return *(*this + n);
+        }
+
+        iterator& operator++ () {
+            ++yi;
+            if( ++j == ny ) {
+                j = 0;
+                yi = yb;
+                ++i;
+                ++xi;
+            }
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        // Row-major index, counted from row zero.
+        size_t index() const { return i * ny + j; }
+
+        iterator& operator+= ( std::ptrdiff_t n ) {
+            const size_t k = size_t( std::ptrdiff_t( index() ) + n );
+            const size_t row = k / ny;
+            xi += std::ptrdiff_t(row) - std::ptrdiff_t(i);
+            i = row;
+            j = k % ny;
+            yi = yb + j;
+            return *this;
+        }
+        iterator& operator-= ( std::ptrdiff_t n ) { return *this += -n; }
+        iterator& operator-- () { return *this -= 1; }
+        iterator operator-- (int) { auto cpy = *this; --(*this); return cpy; }
+
+        iterator operator+ ( std::ptrdiff_t n ) const {
+            auto cpy = *this;
+            return cpy += n;
+        }
+        iterator operator- ( std::ptrdiff_t n ) const {
+            auto cpy = *this;
+            return cpy -= n;
+        }
+        std::ptrdiff_t operator- ( const iterator& o ) const {
+            return std::ptrdiff_t( index() ) - std::ptrdiff_t( o.index() );
+        }
+
+        bool operator== ( const iterator& o ) const {
+            return i == o.i and j == o.j;
+        }
+        bool operator!= ( const iterator& o ) const {
+            return not (*this == o);
+        }
+        bool operator<  ( const iterator& o ) const {
+            return index() < o.index();
+        }
+        bool operator>  ( const iterator& o ) const { return o < *this; }
+        bool operator<= ( const iterator& o ) const { return not (o < *this); }
+        bool operator>= ( const iterator& o ) const { return not (*this < o); }
+    };
+
+    using const_iterator = iterator;
+
+    size_t rows() const { return hi - lo; }
+    size_t size() const { return rows() * ny; }
+
+    iterator begin() const {
+        // With no columns, there is nothing to read in any row.
+        const size_t i = ny ? lo : hi;
+        return iterator( next( pure::begin(xs), i ), pure::begin(ys), i, ny );
+    }
+    iterator end() const {
+        return iterator( next( pure::begin(xs), hi ), pure::begin(ys), hi, ny );
+    }
+
+    /* Rows [b,e) of this view, sharing its xs and ys. */
+    Slice slice( size_t b, size_t e ) const {
+        return Slice( xs, ys, lo + b, lo + e, ny );
+    }
+};
+
+template< class XS, class YS >
+size_t _length( const ProductView<XS,YS>& v ) {
+    return v.size();
+}
+
+/*
+ * The strict functions in List.h give back a Dup of their sequence. For a
+ * view, that's a std::vector of what it yields, so filter(p, xs*ys) or
+ * map(f, lazy::take(n,xs)) read the view once and build a vector.
+ */
+template< class V > using Strict = std::vector< SeqVal<V> >;
+
+template< class F, class S >
+Strict<MapView<F,S>> dup( const MapView<F,S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class P, class S >
+Strict<FilterView<P,S>> dup( const FilterView<P,S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class S >
+Strict<TakeView<S>> dup( const TakeView<S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class P, class S >
+Strict<TakeWhileView<P,S>> dup( const TakeWhileView<P,S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class S >
+Strict<DropView<S>> dup( const DropView<S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class P, class S >
+Strict<DropWhileView<P,S>> dup( const DropWhileView<P,S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class F, class S >
+Strict<ConcatMapView<F,S>> dup( const ConcatMapView<F,S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class P, class S >
+Strict<SplitView<P,S>> dup( const SplitView<P,S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class S >
+Strict<InitsView<S>> dup( const InitsView<S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class S >
+Strict<TailsView<S>> dup( const TailsView<S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class S >
+Strict<PermutationView<S>> dup( const PermutationView<S>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+template< class XS, class YS >
+Strict<ProductView<XS,YS>> dup( const ProductView<XS,YS>& v ) {
+    return dupTo<std::vector>( v );
+}
+
+constexpr struct Cartesian : Binary<Cartesian> {
+    using Binary<Cartesian>::operator();
+
+    template< class XS, class YS, class V = ProductView<XS,YS> >
+    V operator () ( XS&& xs, YS&& ys ) const {
+        return V( forward<XS>(xs), forward<YS>(ys) );
+    }
+} cartesian{};
+
+constexpr struct Map : Binary<Map> {
+    using Binary<Map>::operator();
+
+    template< class F, class S, class V = MapView<Decay<F>,S> >
+    constexpr V operator () ( F&& f, S&& s ) {
+        return V( forward<F>(f), forward<S>(s) );
+    }
+} map{};
+
+constexpr struct Filter : Binary<Filter> {
+    using Binary<Filter>::operator();
+
+    template< class P, class S, class V = FilterView<Decay<P>,S> >
+    constexpr V operator () ( P&& p, S&& s ) {
+        return V( forward<P>(p), forward<S>(s) );
+    }
+} filter{};
+
+constexpr struct Take : Binary<Take> {
+    using Binary<Take>::operator();
+
+    template< class S, class V = TakeView<S> >
+    constexpr V operator () ( size_t n, S&& s ) {
+        return V( n, forward<S>(s) );
+    }
+} take{};
+
+constexpr struct TakeWhile : Binary<TakeWhile> {
+    using Binary<TakeWhile>::operator();
+
+    template< class P, class S, class V = TakeWhileView<Decay<P>,S> >
+    constexpr V operator () ( P&& p, S&& s ) {
+        return V( forward<P>(p), forward<S>(s) );
+    }
+} takeWhile{};
+
+constexpr struct Drop : Binary<Drop> {
+    using Binary<Drop>::operator();
+
+    template< class S, class V = DropView<S> >
+    constexpr V operator () ( size_t n, S&& s ) {
+        return V( n, forward<S>(s) );
+    }
+} drop{};
+
+constexpr struct DropWhile : Binary<DropWhile> {
+    using Binary<DropWhile>::operator();
+
+    template< class P, class S, class V = DropWhileView<Decay<P>,S> >
+    constexpr V operator () ( P&& p, S&& s ) {
+        return V( forward<P>(p), forward<S>(s) );
+    }
+} dropWhile{};
+
+constexpr struct ConcatMap : Binary<ConcatMap> {
+    using Binary<ConcatMap>::operator();
+
+    template< class F, class S, class V = ConcatMapView<Decay<F>,S> >
+    constexpr V operator () ( F&& f, S&& s ) {
+        return V( forward<F>(f), forward<S>(s) );
+    }
+} concatMap{};
+
+constexpr struct SplitBy : Binary<SplitBy> {
+    using Binary<SplitBy>::operator();
+
+    template< class P, class S, class V = SplitView<Decay<P>,S> >
+    constexpr V operator () ( P&& p, S&& s ) {
+        return V( forward<P>(p), forward<S>(s) );
+    }
+} splitBy{};
+
+template< class S, class V = InitsView<S> >
+constexpr V inits( S&& s ) {
+    return V( forward<S>(s) );
+}
+
+template< class S, class V = TailsView<S> >
+constexpr V tails( S&& s ) {
+    return V( forward<S>(s) );
+}
+
+constexpr struct Permutations {
+    template< class S, class V = PermutationView<Decay<S>> >
+    V operator () ( S&& s ) const {
+        return V( forward<S>(s) );
+    }
+} permutations{};
+
+/* lines s -- the pieces of s between '\n's. */
+template< class S >
+constexpr auto lines( S&& s ) -> decltype( splitBy(eq('\n'),declval<S>()) ) {
+    return splitBy( eq('\n'), forward<S>(s) );
+}
+
+/* words s -- the pieces of s between whitespace. */
+template< class S, class V = SplitView<IsSpace,S> >
+constexpr V words( S&& s ) {
+    return V( isSpace, forward<S>(s) );
+}
+
+} // namespace lazy
+
+} // namespace list
+
+} // namespace pure
@@ -2,11 +2,15 @@
 #include "Common.h"
 #include "Functional.h"
 #include "tpl.h"
+#include "Simd.h"
+#include "Hash.h"
+#include "StaticVec.h"
 
 #pragma once
 
 #include <set>
 #include <vector>
+#include <array>
 #include <list>
 #include <memory>
 #include <limits>
@@ -284,8 +288,27 @@ auto tailInserter( S&& s ) -> XBackInsert< S, std::insert_iterator<_S> > {
     return std::inserter( forward<S>(s), end(forward<S>(s)) );
 }
 
+/*
+ * Can R be built from a pair of S's iterators in one step? For random access
+ * iterators, that lets a vector allocate once, and lets a
+ * persistent::Vector share the storage of the one it came from.
+ */
+template< class R, class S, class I = SeqIter<const S> >
+struct CanSliceT : std::integral_constant < bool,
+    std::is_constructible<R,I,I>::value
+    and std::is_same < typename std::iterator_traits<I>::iterator_category,
+                       std::random_access_iterator_tag >::value
+>
+{
+};
+
+template< class R, class S, class X >
+using ESlice = typename std::enable_if< CanSliceT<R,S>::value, X >::type;
+template< class R, class S, class X >
+using XSlice = typename std::enable_if< not CanSliceT<R,S>::value, X >::type;
+
 template< class R, class S >
-R dupExactly( const S& s ) {
+XSlice<R,S,R> dupExactly( const S& s ) {
     R r;
     copy( begin(s), end(s),
           tailInserter(r) );
@@ -293,28 +316,82 @@ R dupExactly( const S& s ) {
 }
 
 template< class R, class S >
-R dupExactly( const S& s, size_t n, size_t off = 0 ) {
+ESlice<R,S,R> dupExactly( const S& s ) {
+    return R( begin(s), end(s) );
+}
+
+template< class R, class S >
+XSlice<R,S,R> dupExactly( const S& s, size_t n, size_t off = 0 ) {
     R r;
     copy_n( next( begin(s), off ),
-            std::min( n+1, length(s) ) - 1,
+            std::min( n, length(s) - off ),
             tailInserter(r) );
     return r;
 }
 
+template< class R, class S >
+ESlice<R,S,R> dupExactly( const S& s, size_t n, size_t off = 0 ) {
+    auto b = next( begin(s), off );
+    return R( b, next( b, std::min(n, length(s) - off) ) );
+}
+
+/*
+ * An argument of S<X,A...> after X, rebuilt for S<Y,...>: an allocator<X>
+ * becomes an allocator<Y>, and likewise a less<X> or char_traits<X>. Other
+ * arguments can't be rebuilt.
+ */
+template< class A, class X, class Y > struct ReMapArg {
+    static constexpr bool ok = false;
+};
+
+template< template<class...> class T, class X, class Y >
+struct ReMapArg< T<X>, X, Y > {
+    static constexpr bool ok = true;
+    using type = T<Y>;
+};
+
+/*
+ * dupTo<R> s gives an R<X>. If R takes its allocator second, as vector,
+ * list and deque do, and s has an allocator, the R gets s's, rebuilt for X.
+ */
+template< template<class...> class R, class X, class S, class = void >
+struct DupToT {
+    using type = R<X>;
+};
+
+template< template<class...> class R, class X, class S >
+struct DupToT< R, X, S, typename std::enable_if <
+    std::is_same< R< X, std::allocator<X> >, R<X> >::value
+    and ReMapArg< typename S::allocator_type, SeqVal<S>, X >::ok
+>::type > {
+    using type = R< X, typename ReMapArg <
+        typename S::allocator_type, SeqVal<S>, X
+    >::type >;
+};
+
+/*
+ * A std::vector of X that allocates as S does: with S's allocator, rebuilt
+ * for X, if it has one. What scanl builds from an ArenaVector, or group
+ * builds from pieces that are ArenaVectors, stays in the arena.
+ */
+template< class S, class X >
+using VectorLike = typename DupToT< std::vector, X, Decay<S> >::type;
+
 template< template<class...> class _R, class S,
-          class R = _R< SeqVal<S> > >
+          class R = typename DupToT< _R, SeqVal<S>, Decay<S> >::type >
 R dupTo( S&& s ) {
     return dupExactly<R>( forward<S>(s) );
 }
 
 template< template<class...> class _R, class S,
-          class R = _R< SeqVal<S> > >
+          class R = typename DupToT< _R, SeqVal<S>, Decay<S> >::type >
 R dupTo( S&& s, size_t n, size_t off = 0 ) {
     return dupExactly<R>( forward<S>(s), n, off );
 }
 
 template< template<class...> class R > struct DupTo {
-    template< class S > using type = R< SeqVal<S> >;
+    template< class S >
+    using type = typename DupToT< R, SeqVal<S>, Decay<S> >::type;
 
     template< class S >
     type<S> operator() ( S&& s ) const {
@@ -353,9 +430,33 @@ constexpr struct DupIf : Binary<DupIf> {
 
 template< class... > struct ReMapT;
 
-template< template<class...> class S, class X > 
-struct ReMapT< S<X> > {
-    template< class Y > using remap = S<Y>;
+template< class ...A > struct AllReMap : std::true_type { };
+
+template< class A, class ...B > struct AllReMap< A, B... >
+    : std::integral_constant< bool, A::ok and AllReMap<B...>::value >
+{
+};
+
+/*
+ * S<Y,A'...> when every A can be rebuilt, so that a container keeps its
+ * allocator (see Arena.h) through map, filter and the rest; otherwise, S<Y>
+ * and its defaults.
+ */
+template< bool, template<class...> class S, class Y, class ...A >
+struct ReMapWith {
+    using type = S<Y>;
+};
+
+template< template<class...> class S, class Y, class ...A >
+struct ReMapWith< true, S, Y, A... > {
+    using type = S< Y, typename A::type... >;
+};
+
+template< template<class...> class S, class X, class ...A >
+struct ReMapT< S<X,A...> > {
+    template< class Y > using remap = typename ReMapWith <
+        AllReMap< ReMapArg<A,X,Y>... >::value, S, Y, ReMapArg<A,X,Y>...
+    >::type;
 };
 
 template< class X, size_t N >
@@ -363,6 +464,11 @@ struct ReMapT< std::array<X,N> > {
     template< class Y > using remap = std::array<Y,N>;
 };
 
+template< class X, size_t N >
+struct ReMapT< StaticVec<X,N> > {
+    template< class Y > using remap = StaticVec<Y,N>;
+};
+
 template< class S, class Y >
 using Remap = typename ReMapT< Dup<S> >::template remap<Y>;
 
@@ -373,7 +479,7 @@ D dup( S&& s, size_t n ) {
 
 template< class S, class D = Dup<S> >
 D dup( S&& s, size_t start, size_t end ) {
-    return dupExactly<D>( forward<S>(s), end-start, end );
+    return dupExactly<D>( forward<S>(s), end-start, start );
 }
 
 template< class S > 
@@ -386,11 +492,33 @@ Dup<S> init( const S& s ) {
     return dup( init_wrap(s) );
 }
 
+template< class I > struct XRange;
+
+template< class I, class R >
+using ESigned =
+    typename std::enable_if< std::is_signed<I>::value, R >::type;
+template< class I, class R >
+using XSigned =
+    typename std::enable_if< not std::is_signed<I>::value, R >::type;
+
 constexpr struct Reverse {
     template< class S >
     Dup<S> operator () ( S&& s ) const {
         return dup( reverse_wrap(forward<S>(s)) );
     }
+
+    /* O(1): the same progression, counting the other way. */
+    template< class I >
+    constexpr ESigned< I, XRange<I> > operator () ( XRange<I> r ) const {
+        return XRange<I>( r.back(), r.front() - r.stride, I(0) - r.stride );
+    }
+
+    // An unsigned range can't count down.
+    template< class I, class V = std::vector<I> >
+    XSigned< I, V > operator () ( XRange<I> r ) const {
+        return V( std::reverse_iterator<typename XRange<I>::iterator>(r.e),
+                  std::reverse_iterator<typename XRange<I>::iterator>(r.b) );
+    }
 } reverse{};
 
 template< class F, class RI, class XS >
@@ -415,15 +543,37 @@ R mapExactly( F&& f, XS&& xs, YS&& ...ys ) {
     return r;
 }
 
+/*
+ * Can map write its results over its copy of an S? Not if the result is
+ * another type, or if S's elements are const (like std::set's, or a
+ * persistent::Vector's).
+ */
+template< class R, class S >
+struct CanMapInPlace : std::integral_constant < bool,
+    std::is_same<R,S>::value
+    and not std::is_const <
+        typename std::remove_reference< SeqRef<S&> >::type
+    >::value
+>
+{
+};
+
+template< class R, class S, class X >
+using EInPlace =
+    typename std::enable_if< CanMapInPlace<R,S>::value, X >::type;
+template< class R, class S, class X >
+using XInPlace =
+    typename std::enable_if< not CanMapInPlace<R,S>::value, X >::type;
+
 template< class R, class F, class S >
-auto mapExactly( F&& f, S&& s ) -> XSame<R,Decay<S>,R> {
+auto mapExactly( F&& f, S&& s ) -> XInPlace<R,Decay<S>,R> {
     R r;
     _map( forward<F>(f), tailInserter(r), forward<S>(s) );
     return r;
 }
 
 template< class R, class F, class S >
-auto mapExactly( F&& f, S r ) -> ESame<R,S,S> {
+auto mapExactly( F&& f, S r ) -> EInPlace<R,S,S> {
     _map( forward<F>(f), begin(r), r );
     return r;
 }
@@ -476,9 +626,35 @@ constexpr R mapTo( F&& f, S&& ...s ) {
 template< template<class...> class R, class F, class ...S >
 using ResultMapTo = decltype( mapTo<R>(declval<F>(),declval<S>()...) );
 
+/*
+ * Execution policies.
+ *
+ * map, filter, zipWith, all, any, none, find, elem, sort, concatMap and vmap
+ * also take an execution policy before their usual arguments:
+ *      map( par, f, xs )
+ * List.h defines no policies itself; it hands the call to the policy's
+ * member of the same name. Parallel.h defines par and par_unseq.
+ */
+struct ExecutionPolicy { };
+
+template< class P >
+using IsPolicy = std::is_base_of< ExecutionPolicy, Decay<P> >;
+
+template< class P, class R >
+using EPolicy = typename std::enable_if< IsPolicy<P>::value, R >::type;
+template< class P, class R >
+using XPolicy = typename std::enable_if< not IsPolicy<P>::value, R >::type;
+
 constexpr struct Map : Binary<Map> {
     using Binary<Map>::operator();
 
+    template< class P, class F, class S >
+    constexpr auto operator () ( const P& p, F&& f, S&& xs ) const
+        -> EPolicy< P, decltype( p.map(declval<F>(),declval<S>()) ) >
+    {
+        return p.map( forward<F>(f), forward<S>(xs) );
+    }
+
     /* map f {1,2,3} -> { f(1), f(2), f(3) } */
     template< class S, class X = SeqVal<S>,
               class F, class FX = Result<F,X>, class R = Remap<S,FX> >
@@ -507,6 +683,7 @@ constexpr struct Map : Binary<Map> {
      * sequence for every x.
      */
     template< class F, class XS, class YS, class ...ZS,
+              class = XPolicy<F,void>,
               class R = Remap <
                   XS,
                   decltype (
@@ -542,6 +719,11 @@ void vmap( F&& f, S&& s ) {
     std::for_each( begin(forward<S>(s)), end(forward<S>(s)), forward<F>(f) );
 }
 
+template< class P, class F, class S >
+EPolicy<P,void> vmap( const P& p, F&& f, S&& s ) {
+    p.vmap( forward<F>(f), forward<S>(s) );
+}
+
 template< template<class...> class S, class X, class ...XS, class F,
           class R = S<X,XS...> >
 auto map_it( F&& f, S<X,XS...> xs ) -> ESame< Result<F,X>, X, R >
@@ -586,14 +768,30 @@ constexpr struct Each : Binary<Each> {
 } each{};
 
 /* accuml -- foldl implementaton */
+template< class F, class X, class ...I, size_t ...k >
+X accumlIt( F&& f, X x, std::tuple<I...> its, const std::tuple<I...>& ends,
+            tpl::IndexList<k...> )
+{
+    // Loop while no sequence has run out.
+    while( true ) {
+        bool more = true;
+        (void) std::initializer_list<int> {
+            ( more = more and std::get<k>(its) != std::get<k>(ends), 0 )...
+        };
+        if( not more )
+            return x;
+
+        x = forward<F>(f)( std::move(x), *std::get<k>(its)... );
+        (void) std::initializer_list<int>{ ( ++std::get<k>(its), 0 )... };
+    }
+}
+
 template< class F, class X, class ...XS >
-constexpr Decay<X> accuml( F&& f, X&& x, const XS& ...xs ) {
-    return each( notNull, xs... ) ?
-        accuml( forward<F>(f), 
-                forward<F>(f)( forward<X>(x), 
-                               head(xs)... ),
-                tail_wrap(xs)... )
-        : forward<X>(x);
+Decay<X> accuml( F&& f, X&& x, const XS& ...xs ) {
+    return accumlIt( forward<F>(f), Decay<X>( forward<X>(x) ),
+                     std::make_tuple( begin(xs)... ),
+                     std::make_tuple( end(xs)... ),
+                     tpl::BuildList< sizeof...(XS) >() );
 }
 
 // GCC does not apply proper tail recursion here,
@@ -672,6 +870,15 @@ constexpr struct Append_ {
     }
 } append_{};
 
+/* Reserve room for n elements in s, if s can. */
+template< class S >
+auto reserve_( S& s, size_t n ) -> decltype( s.reserve(n), void() ) {
+    s.reserve( n );
+}
+
+template< class S >
+void reserve_( S&, ... ) { }
+
 constexpr struct Append : Chainable<Append> {
     using Chainable<Append>::operator();
 
@@ -780,7 +987,7 @@ std::pair<Acc,S> mapAccumR( F&& f, Acc a, const S& s ) {
 }
 
 template< class F, class X, class S,
-          class V = std::vector<Decay<X>> >
+          class V = VectorLike< Dup<S>, Decay<X> > >
 V scanl( F&& f, X&& x, const S& s ) {
     V v{ forward<X>(x) };
     for( const auto& y : s )
@@ -813,12 +1020,191 @@ Scanr<F,S> scanr( F&& f, S&& s ) {
                   last(forward<S>(s)), init_wrap(forward<S>(s)) );
 }
 
+/*
+ * Segmented X -- a growable sequence stored in blocks that never move.
+ * Block k holds 2^(k+4) elements, so finding element i's block is one bit
+ * scan, and adding a block never copies the ones before it. Unlike a
+ * std::vector, push_back never invalidates references or iterators, and the
+ * peak memory while growing is the storage itself, not twice it.
+ */
+template< class X > struct Segmented {
+    static constexpr size_t FIRST = 4; // log2 of the first block's size.
+
+    using value_type      = X;
+    using reference       = X&;
+    using const_reference = const X&;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Each block is reserved to its full size up front and never grows
+    // past it, so its elements never move.
+    std::vector< std::vector<X> > blocks;
+    size_t n = 0;
+
+    static size_t log2( size_t x ) {
+#if defined(__GNUC__)
+        return 8*sizeof(unsigned long long) - 1 - __builtin_clzll( x );
+#else
+        size_t r = 0;
+        while( x >>= 1 )
+            r++;
+        return r;
+#endif
+    }
+
+    // The block holding element i, and where in it.
+    static size_t blockOf( size_t i ) {
+        return log2( i + (size_t(1) << FIRST) ) - FIRST;
+    }
+    static size_t indexIn( size_t i, size_t k ) {
+        return i + (size_t(1) << FIRST) - (size_t(1) << (k + FIRST));
+    }
+
+    template< class S, class R > struct Iter
+        : std::iterator< std::random_access_iterator_tag, X,
+                         std::ptrdiff_t, typename std::remove_reference<R>::type*,
+                         R >
+    {
+        S* s;
+        size_t i;
+
+        Iter( S* s, size_t i ) : s(s), i(i) { }
+
+        // const_iterator from iterator.
+        template< class _S, class _R >
+        Iter( const Iter<_S,_R>& o ) : s(o.s), i(o.i) { }
+
+        R operator* () const { return (*s)[i]; }
+        typename std::remove_reference<R>::type* operator-> () const {
+            return &(*s)[i];
+        }
+        R operator[] ( std::ptrdiff_t n ) const { return (*s)[i+n]; }
+
+        Iter& operator++ () { i++; return *this; }
+        Iter& operator-- () { i--; return *this; }
+        Iter operator++ (int) { auto c = *this; i++; return c; }
+        Iter operator-- (int) { auto c = *this; i--; return c; }
+
+        Iter& operator+= ( std::ptrdiff_t n ) { i += n; return *this; }
+        Iter& operator-= ( std::ptrdiff_t n ) { i -= n; return *this; }
+        Iter operator+ ( std::ptrdiff_t n ) const { return Iter( s, i+n ); }
+        Iter operator- ( std::ptrdiff_t n ) const { return Iter( s, i-n ); }
+        std::ptrdiff_t operator- ( const Iter& o ) const {
+            return std::ptrdiff_t(i) - std::ptrdiff_t(o.i);
+        }
+
+        bool operator== ( const Iter& o ) const { return i == o.i; }
+        bool operator!= ( const Iter& o ) const { return i != o.i; }
+        bool operator<  ( const Iter& o ) const { return i <  o.i; }
+        bool operator>  ( const Iter& o ) const { return i >  o.i; }
+        bool operator<= ( const Iter& o ) const { return i <= o.i; }
+        bool operator>= ( const Iter& o ) const { return i >= o.i; }
+    };
+
+    using iterator       = Iter< Segmented, X& >;
+    using const_iterator = Iter< const Segmented, const X& >;
+
+    Segmented() { }
+
+    Segmented( std::initializer_list<X> l ) {
+        for( const X& x : l )
+            push_back( x );
+    }
+
+    template< class I >
+    Segmented( I b, I e ) {
+        for( ; b != e; ++b )
+            push_back( *b );
+    }
+
+    // A vector's copy has no room to spare, so copy each block into one
+    // reserved to full size, or the copy's next push_back would move it.
+    Segmented( const Segmented& o ) : n(o.n) {
+        blocks.reserve( o.blocks.size() );
+        for( size_t k = 0; k < o.blocks.size(); k++ ) {
+            blocks.emplace_back();
+            blocks.back().reserve( size_t(1) << (k + FIRST) );
+            blocks.back().insert( blocks.back().end(),
+                                  o.blocks[k].begin(), o.blocks[k].end() );
+        }
+    }
+
+    Segmented( Segmented&& o ) : blocks( std::move(o.blocks) ), n(o.n) {
+        o.blocks.clear();
+        o.n = 0;
+    }
+
+    Segmented& operator= ( const Segmented& o ) {
+        if( this != &o )
+            *this = Segmented( o );
+        return *this;
+    }
+
+    Segmented& operator= ( Segmented&& o ) {
+        blocks.swap( o.blocks );
+        std::swap( n, o.n );
+        return *this;
+    }
+
+    size_t size()  const { return n; }
+    bool   empty() const { return n == 0; }
+
+    X& operator[] ( size_t i ) {
+        size_t k = blockOf( i );
+        return blocks[k][ indexIn(i,k) ];
+    }
+    const X& operator[] ( size_t i ) const {
+        size_t k = blockOf( i );
+        return blocks[k][ indexIn(i,k) ];
+    }
+
+    X& front() { return (*this)[0]; }
+    X& back()  { return (*this)[n-1]; }
+    const X& front() const { return (*this)[0]; }
+    const X& back()  const { return (*this)[n-1]; }
+
+    iterator begin() { return iterator( this, 0 ); }
+    iterator end()   { return iterator( this, n ); }
+    const_iterator begin() const { return const_iterator( this, 0 ); }
+    const_iterator end()   const { return const_iterator( this, n ); }
+
+    template< class ...Y >
+    void emplace_back( Y&& ...y ) {
+        size_t k = blockOf( n );
+        if( k == blocks.size() ) {
+            blocks.emplace_back();
+            blocks.back().reserve( size_t(1) << (k + FIRST) );
+        }
+        blocks[k].emplace_back( forward<Y>(y)... );
+        n++;
+    }
+
+    void push_back( const X& x ) { emplace_back( x ); }
+    void push_back( X&& x )      { emplace_back( move(x) ); }
+};
+
+/*
+ * Remember f xs -- the sequence xs ++ [f xs, f (xs ++ [f xs]), ...]
+ * Each element is computed once, when first read, and kept. If f can take
+ * every element so far as a Segmented, it gets one, and references to them
+ * stay valid as it grows; otherwise, f gets the std::vector it always has.
+ */
+template< class F, class X > struct RememberStoreT {
+    template< class _F, class S = Segmented<X> > static auto f( _F& f )
+        -> decltype( f( declval<const S&>() ), S() );
+    template< class _F > static auto f(...) -> std::vector<X>;
+
+    using type = decltype( f<F>( declval<F&>() ) );
+};
+
+template< class F, class X >
+using RememberStore = typename RememberStoreT<F,X>::type;
+
 template< class F, class X > struct Remember {
-    using container  = std::vector<Decay<X>>;
+    using container  = RememberStore<F,Decay<X>>;
     using reference  = typename container::reference;
     using const_reference = typename container::const_reference;
     using value_type = typename container::value_type;
-    using citerator  = typename container::iterator;
     using difference_type = typename container::difference_type;
 
     // Unfortunately, as a requirement for declaring the Fnct::operator() as a
@@ -833,49 +1219,34 @@ template< class F, class X > struct Remember {
     struct iterator 
         : std::iterator<std::bidirectional_iterator_tag,value_type> 
     {
-        const Remember& c;
-        citerator it;
+        const Remember* c;
+        size_t i;
 
-        iterator( const Remember<F,X>& _c )
-            : c(_c), it(std::begin(c.c))
-        {
-        }
-        iterator( const Remember<F,X>& _c, citerator i )
-            : c(_c), it(i)
+        iterator( const Remember<F,X>& _c, size_t i = 0 )
+            : c(&_c), i(i)
         {
         }
 
-        iterator& operator= ( const iterator& other ) {
-            it = other.it;
-            return *this;
-        };
-
-        void _grow() {
-            size_t dist = it - std::begin(c.c);
-            c.c.emplace_back( c.f(c.c) );
-            it = std::begin(c.c) + dist;
-        }
-
         void grow() {
-            if( it == std::end(c.c) ) 
-                _grow();
+            if( i == c->c.size() ) 
+                c->c.push_back( c->f(c->c) );
         }
 
-
         iterator& operator++ () { 
             grow();
-            it++;
+            i++;
             return *this;
         }
 
         iterator& operator-- () { 
-            it--;
+            i--;
             return *this;
         }
 
         iterator operator++ (int) { 
+            iterator copy = *this;
             ++(*this);
-            return iterator( c, prev(it) );
+            return copy;
         }
 
         iterator operator-- (int) { 
@@ -886,17 +1257,15 @@ template< class F, class X > struct Remember {
 
         const_reference operator* () {
             grow();
-            return *it;
+            return c->c[i];
         }
 
-        difference_type operator- ( const iterator& i ) {
-            return it - i.it;
+        difference_type operator- ( const iterator& o ) const {
+            return difference_type(i) - difference_type(o.i);
         }
 
         constexpr bool operator== ( const iterator& ) { return false; }
         constexpr bool operator!= ( const iterator& ) { return true;  }
-
-        constexpr operator citerator () { return it; }
     };
 
     
@@ -904,8 +1273,8 @@ template< class F, class X > struct Remember {
     Remember( F f, _X&& ...x ) 
         : f(move(f)), c{forward<_X>(x)...} { }
     
-    iterator begin() const { return *this; }
-    iterator end()   const { return iterator(*this,std::end(c)); }
+    iterator begin() const { return iterator( *this ); }
+    iterator end()   const { return iterator( *this, c.size() ); }
 };
 
 template< class F, class X >
@@ -915,7 +1284,7 @@ constexpr size_t _length( const Remember<F,X>& ) {
 
 template< class F, class X, class I = Remember<F,X> >
 std::vector<X> dup( const Remember<F,X>& c ) {
-    return c.c;
+    return std::vector<X>( begin(c.c), end(c.c) );
 }
 
 template< class F, class X, class I = Remember<F,X> >
@@ -923,6 +1292,19 @@ std::vector<X> dup( Remember<F,X> c, size_t n ) {
     return dupTo<std::vector>( move(c), n );
 }
 
+/*
+ * memorize f x1 ... xn -- a Remember f, seeded with x1 ... xn.
+ *
+ * Only an f that takes its argument generically, or as a
+ * const Segmented<X>&, gets segmented storage. An f taking a
+ * const std::vector<X>& still compiles, but gets the old vector: each
+ * growth may copy the whole history and move every element.
+ *
+ *      // Segmented: references into the history stay valid.
+ *      struct NextPrime {
+ *          template< class S > unsigned operator () ( const S& past ) const;
+ *      };
+ */
 constexpr struct Memorize {
     template< class F, class X, class ...Y, class R = Remember<F,X> >
     constexpr R operator () ( F f, X x, Y&& ...y ) {
@@ -930,37 +1312,128 @@ constexpr struct Memorize {
     }
 } memorize{};
 
+/*
+ * Window N f xs -- the sequence xs ++ [x(N), x(N+1)...] where
+ *      x(k) = f( x(k-N), ..., x(k-1) )
+ * Like memorize, but f only sees the last N elements, so nothing else is
+ * kept: each iterator holds those N and computes the rest as it goes.
+ * Memory stays O(N) however far the sequence is read, at the cost of
+ * recomputing it for each new iterator from begin(). Reading gives a copy:
+ * the element an iterator holds is gone once it moves on.
+ */
+template< size_t N, class F, class X > struct Window {
+    using value_type      = Decay<X>;
+    using reference       = value_type;
+    using const_reference = reference;
+    using difference_type = std::ptrdiff_t;
+    using window          = std::array<value_type,N>;
+
+    F f;
+    window seeds;
+
+    struct iterator
+        : std::iterator< std::forward_iterator_tag, value_type,
+                         difference_type, const value_type*, reference >
+    {
+        const F* f;
+        window w; // w[h] is x(i); then x(i+1), etc., modulo N.
+        size_t h = 0;
+        size_t i;
+
+        iterator( const Window& s, size_t i ) : f(&s.f), w(s.seeds), i(i) { }
+
+        template< size_t ...k >
+        value_type step( tpl::IndexList<k...> ) const {
+            return (*f)( w[ (h+k) % N ]... );
+        }
+
+        reference operator* () const { return w[h]; }
+
+        iterator& operator++ () {
+            w[h] = step( typename tpl::IListBuilder<N>::type() );
+            h = (h + 1) % N;
+            i++;
+            return *this;
+        }
+        iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
+
+        difference_type operator- ( const iterator& o ) const {
+            return difference_type(i) - difference_type(o.i);
+        }
+
+        bool operator== ( const iterator& o ) const { return i == o.i; }
+        bool operator!= ( const iterator& o ) const { return i != o.i; }
+    };
+
+    template< class ...Y >
+    constexpr Window( F f, Y&& ...y )
+        : f( move(f) ), seeds{{ forward<Y>(y)... }}
+    {
+        static_assert( sizeof...(Y) == N, "Window N needs N seeds." );
+    }
+
+    iterator begin() const { return iterator( *this, 0 ); }
+    iterator end()   const {
+        return iterator( *this, std::numeric_limits<size_t>::max() );
+    }
+};
+
+template< size_t N, class F, class X >
+constexpr size_t _length( const Window<N,F,X>& ) {
+    return std::numeric_limits<size_t>::max();
+}
+
+template< size_t N, class F, class X,
+          class V = VectorLike< Decay<X>, Decay<X> > >
+V dup( const Window<N,F,X>& w ) {
+    return V( std::begin(w.seeds), std::end(w.seeds) );
+}
+
+template< size_t N, class F, class X,
+          class V = VectorLike< Decay<X>, Decay<X> > >
+V dup( const Window<N,F,X>& w, size_t n ) {
+    return dupExactly<V>( w, n );
+}
+
+/* iterateN<N> f x1 ... xN -- a Window N. */
+template< size_t N, class F, class X, class ...Y, class W = Window<N,F,X> >
+constexpr W iterateN( F f, X x, Y&& ...y ) {
+    return W( move(f), move(x), forward<Y>(y)... );
+}
+
 template< class F, class X >
-using Iterate = Remember< Composition<F,Last>, X >;
+using Iterate = Window< 1, F, X >;
 
 struct ReturnIterate : Binary<ReturnIterate> {
     using Binary<ReturnIterate>::operator();
 
+    /* iterate f x = [x, f x, f (f x), ...] */
     template< class F, class X, class I = Iterate<F,X> >
     constexpr I operator () ( F f, X x ) {
-        return memorize (
-            compose( move(f), Last() ),
-            move(x)
-        );
+        return I( move(f), move(x) );
     }
 } iterate{};
 
 constexpr auto repeat = iterate( Id() );
 
 constexpr struct BiIterate {
-    using L1 = decltype( last.with(1) );
-    using L2 = Last;
-
-    template< class F, class X,
-              class I = Remember< BComposition<F,L1,L2>, X > >
+    /* biIterate f a b = [a, b, f a b, f b (f a b), ...] */
+    template< class F, class X, class I = Window<2,F,X> >
     I operator () ( F f, X a, X b ) const {
-        return I (
-            bcompose( move(f), last.with(1), last ),
-            move(a), move(b)
-        );
+        return I( move(f), move(a), move(b) );
     }
 } biIterate{};
 
+/*
+ * XRange I -- the arithmetic progression [b, b+stride, b+2*stride, ...] up to
+ * but not including e, for integral I. A negative stride (for signed I)
+ * counts down.
+ *
+ * Nothing is stored but the ends, so length, elem, sum, maximum, minimum,
+ * take, drop, reverse, filter (divisibleBy k) and intersect work them out
+ * in O(1) (or O(log stride)) instead of walking the range. Where the result
+ * is a progression, it's another XRange.
+ */
 template< class I > struct XRange {
     using value_type = I;
     using difference_type = ItDist<I>;
@@ -983,24 +1456,28 @@ template< class I > struct XRange {
 
         constexpr const_reference operator* () const { return i; }
         reference operator* () { return i; }
-        iterator operator++ () { ++i; return *this; }
-        iterator operator-- () { --i; return *this; }
+        iterator operator++ () { i += stride; return *this; }
+        iterator operator-- () { i -= stride; return *this; }
         iterator operator-- (int) { auto cpy = *this; --(*this); return cpy; }
         iterator operator++ (int) { auto cpy = *this; ++(*this); return cpy; }
 
 
-        constexpr iterator operator+ ( difference_type n ) { 
-            return iterator( i + n, stride );
+        constexpr iterator operator+ ( difference_type n ) const { 
+            return iterator( i + n * stride, stride );
         }
-        constexpr iterator operator- ( difference_type n ) {
-            return iterator( i - n, stride );
+        constexpr iterator operator- ( difference_type n ) const {
+            return iterator( i - n * stride, stride );
         } 
-        constexpr difference_type operator- ( iterator other ) { 
+        constexpr difference_type operator- ( iterator other ) const { 
             return (i - *other) / stride;
         }
 
-        constexpr bool operator== ( iterator other ) { return i == *other; }
-        constexpr bool operator!= ( iterator other ) { return i != *other; }
+        constexpr bool operator== ( iterator other ) const {
+            return i == *other;
+        }
+        constexpr bool operator!= ( iterator other ) const {
+            return i != *other;
+        }
 
         iterator& operator+= ( difference_type other ) { 
             i += other * stride; 
@@ -1013,16 +1490,48 @@ template< class I > struct XRange {
         }
     };
 
+    /*
+     * The number of steps from b towards e before reaching or passing it.
+     * A stride of zero never gets anywhere, so its range is empty.
+     */
+    static constexpr size_t steps( I b, I e, I stride ) {
+        return stride > I(0) ? ( e > b ? (e - b - 1) / stride + 1 : 0 )
+             : stride == I(0) ? 0
+             : b > e ? (b - e - 1) / (I(0) - stride) + 1 : 0;
+    }
+
     value_type stride;
     iterator b, e;
 
+    // Iteration stops when it lands exactly on e, so round e to a whole
+    // number of strides from b.
     constexpr XRange( value_type b, value_type e, value_type stride=1 ) 
-        : stride(stride), b(b,stride), e(e,stride)  { }
+        : stride(stride), b(b,stride),
+          e( b + I(steps(b,e,stride)) * stride, stride )  { }
+
+    /* [b,e) where e must be a whole number of strides from b. */
     constexpr XRange( iterator b, iterator e, value_type stride=1 ) 
         : stride(stride), b(b,stride), e(e,stride)  { }
 
-    constexpr iterator begin() { return b; }
-    constexpr iterator end()   { return e; }
+    constexpr iterator begin() const { return b; }
+    constexpr iterator end()   const { return e; }
+
+    constexpr size_t size() const {
+        return empty() ? 0 : (*e - *b) / stride;
+    }
+    constexpr bool  empty() const { return *b == *e; }
+
+    constexpr I front() const { return *b; }
+    constexpr I back()  const { return *e - stride; }
+
+    /* The least and greatest elements. */
+    constexpr I lowest()  const { return stride > I(0) ? front() : back(); }
+    constexpr I highest() const { return stride > I(0) ? back() : front(); }
+
+    /* The distance between neighbours. */
+    constexpr I step() const {
+        return stride > I(0) ? stride : I(0) - stride;
+    }
 };
 
 template< class I >
@@ -1030,16 +1539,134 @@ std::vector<I> dup( XRange<I> r ) {
     return dupTo<std::vector>( r );
 }
 
+template< class I >
+constexpr size_t _length( const XRange<I>& r ) {
+    return r.size();
+}
+
 template< class I, class R = XRange<I> >
 constexpr R init( XRange<I> r ) {
-    return R( r.b, prev(r.e) );
+    return R( r.b, prev(r.e), r.stride );
 }
 
 template< class I, class R = XRange<I> >
 constexpr R tail( XRange<I> r ) {
-    return R( next(r.b), r.e );
+    return R( next(r.b), r.e, r.stride );
+}
+
+/*
+ * The arithmetic behind XRange's set operations. Each works on an
+ * ascending progression lo, lo+d, ... of n elements.
+ */
+namespace progression {
+
+/* x mod k, in [0,k), for x of either sign. */
+template< class I >
+constexpr I modulo( I x, I k ) {
+    return x % k < I(0) ? x % k + k : x % k;
+}
+
+template< class I >
+I gcd( I a, I b ) {
+    while( b != I(0) ) {
+        I t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
 }
 
+/* a*b mod m, without overflow. */
+inline unsigned long long mulMod( unsigned long long a, unsigned long long b,
+                                  unsigned long long m )
+{
+    unsigned long long r = 0;
+    for( a %= m; b > 0; b >>= 1 ) {
+        if( b & 1 )
+            r = r >= m - a ? r - (m - a) : r + a;
+        a = a >= m - a ? a - (m - a) : a + a;
+    }
+    return r;
+}
+
+/* The inverse of a mod m, for a and m coprime (by extended Euclid). */
+inline unsigned long long invMod( unsigned long long a, unsigned long long m ) {
+    unsigned long long t = 0, nt = 1, r = m, nr = a % m;
+    while( nr != 0 ) {
+        unsigned long long q = r / nr;
+        unsigned long long qt = mulMod( q, nt, m );
+        unsigned long long tmp = t >= qt ? t - qt : t + (m - qt);
+        t = nt; nt = tmp;
+        tmp = r - q * nr;
+        r = nr; nr = tmp;
+    }
+    return t;
+}
+
+/* lo, lo+d, ..., as n elements. */
+template< class I >
+constexpr XRange<I> make( I lo, I d, size_t n ) {
+    return XRange<I>( typename XRange<I>::iterator( lo, d ),
+                      typename XRange<I>::iterator( lo + I(n) * d, d ), d );
+}
+
+/*
+ * The elements lo + i*d, for i in [0,n), congruent to c mod k. Solving
+ *      i*d = c - lo  (mod k)
+ * gives every i0 + j*(k/g), where g = gcd(d,k), or nothing if g doesn't
+ * divide c - lo.
+ */
+template< class I >
+XRange<I> congruent( I lo, I d, size_t n, I c, I k ) {
+    const I g = gcd( modulo(d,k), k );
+    const I cm = modulo( c, k ), lm = modulo( lo, k );
+    const I diff = cm >= lm ? I(cm - lm) : I(cm + (k - lm));
+    if( n == 0 or diff % g != I(0) )
+        return make( lo, d, 0 );
+
+    using U = unsigned long long;
+    const U m = U( k / g );
+    const U i0 = mulMod( U(diff / g), invMod( U(modulo(d,k) / g), m ), m );
+    if( i0 >= n )
+        return make( lo, d, 0 );
+
+    return make( I(lo + I(i0) * d), I(d * I(m)),
+                 size_t( (n - 1 - i0) / m + 1 ) );
+}
+
+/* Is x an element of r? */
+template< class X, class I >
+constexpr bool contains( const XRange<I>& r, const X& x ) {
+    return not r.empty() and r.lowest() <= x and x <= r.highest()
+        and ( x - r.lowest() ) % r.step() == 0;
+}
+
+/* m, an ascending progression, in the same direction as r. */
+template< class I >
+constexpr XRange<I> orderedLike( const XRange<I>& r, const XRange<I>& m ) {
+    return r.stride > I(0) ? m
+        : XRange<I>( m.back(), m.front() - m.stride, I(0) - m.stride );
+}
+
+/* The elements of r in [lo,hi]; lo and hi must be elements of some range. */
+template< class I >
+XRange<I> clip( const XRange<I>& r, I lo, I hi ) {
+    if( r.empty() or lo > hi or r.highest() < lo or r.lowest() > hi )
+        return make( lo, r.step(), 0 );
+
+    const I d = r.step();
+    const I first = r.lowest() < lo
+        ? I( r.lowest() + (lo - r.lowest() + d - 1) / d * d )
+        : r.lowest();
+    const I last = r.highest() > hi
+        ? I( r.highest() - (r.highest() - hi + d - 1) / d * d )
+        : r.highest();
+    return make( first, d,
+                 first > last ? 0 : size_t( (last - first) / d + 1 ) );
+}
+
+} // namespace progression
+
 using IRange = XRange<unsigned int>;
 
 /* 
@@ -1048,8 +1675,9 @@ using IRange = XRange<unsigned int>;
  */
 constexpr IRange enumerate( unsigned int b, unsigned int e, 
                             unsigned int stride = 1 ) {
-    // Adding one to the en
-    return IRange( b, e + stride, stride ); 
+    // Adding one to the end makes it inclusive; the constructor rounds it to
+    // a whole number of strides.
+    return IRange( b, e + 1, stride ); 
 }
 
 /* enumerate n = [n,n+1,n+2,...] */
@@ -1155,6 +1783,11 @@ constexpr struct Sort {
         std::sort( begin(s), end(s) );
         return s;
     }
+
+    template< class P, class S >
+    EPolicy<P,S> operator () ( const P& p, S s ) const {
+        return p.sort( move(s) );
+    }
 } sort{};
 
 constexpr struct Ordered {
@@ -1199,6 +1832,23 @@ constexpr struct Filter : Binary<Filter> {
     V operator () ( F&& f, const std::initializer_list<X>& l ) const {
         return dupIf( forward<F>(f), l );
     }
+
+    /* filter (divisibleBy k) r -- the multiples of k in r, as an XRange. */
+    template< class I, class K >
+    XRange<I> operator () ( NComposition<BinaryNot,RPart<Mod,K>> p,
+                            XRange<I> r ) const
+    {
+        return progression::orderedLike( r, progression::congruent (
+            r.lowest(), r.step(), r.size(), I(0), I(p.g.x)
+        ) );
+    }
+
+    template< class P, class F, class S >
+    auto operator () ( const P& p, F&& f, const S& s ) const
+        -> EPolicy< P, decltype( p.filter(declval<F>(),s) ) >
+    {
+        return p.filter( forward<F>(f), s );
+    }
 } filter{};
 
 constexpr struct Filtrate {
@@ -1241,6 +1891,13 @@ constexpr struct Find : Binary<Find> {
         const auto it = find_if( begin(s), e, forward<F>(f) );
         return MaybeElem<I>( it, e );
     }
+
+    template< class P, class F, class S >
+    auto operator () ( const P& p, F&& f, const S& s ) const
+        -> EPolicy< P, decltype( p.find(declval<F>(),s) ) >
+    {
+        return p.find( forward<F>(f), s );
+    }
 } find{};
 
 constexpr struct FindFirst : Binary<FindFirst> {
@@ -1333,6 +1990,11 @@ constexpr struct Take : Binary<Take> {
     D operator () ( size_t n, S&& s ) const {
         return dup( forward<S>(s), n );
     }
+
+    template< class I >
+    constexpr XRange<I> operator () ( size_t n, XRange<I> r ) const {
+        return XRange<I>( r.b, r.b + std::min(n, r.size()), r.stride );
+    }
 } take{};
 
 constexpr struct Replicate {
@@ -1374,6 +2036,11 @@ constexpr struct Drop : Binary<Drop> {
     constexpr S operator () ( size_t n, const S& s ) {
         return S( next(begin(s),n), end(s) );
     }
+
+    template< class I >
+    constexpr XRange<I> operator () ( size_t n, XRange<I> r ) const {
+        return XRange<I>( r.b + std::min(n, r.size()), r.e, r.stride );
+    }
 } drop{};
 
 constexpr struct DropWhile : Binary<DropWhile> {
@@ -1398,6 +2065,35 @@ constexpr struct DropWhileEnd : Binary<DropWhileEnd> {
     }
 } dropWhileEnd{};
 
+/*
+ * Is S a std::vector or std::array of numbers? If so, the reductions below
+ * (sum, product, maximum, elem, all, ...) use the kernels in Simd.h.
+ */
+template< class S > struct IsContiguousArithT : std::false_type { };
+
+template< class X > struct IsArithElem
+    : std::integral_constant < bool,
+        std::is_arithmetic<X>::value and not std::is_same<X,bool>::value
+    >
+{
+};
+
+template< class X, class A >
+struct IsContiguousArithT< std::vector<X,A> > : IsArithElem<X> { };
+
+template< class X, size_t N >
+struct IsContiguousArithT< std::array<X,N> > : IsArithElem<X> { };
+
+template< class S >
+using IsContiguousArith = IsContiguousArithT< Decay<S> >;
+
+template< class S, class R >
+using EContiguous =
+    typename std::enable_if< IsContiguousArith<S>::value, R >::type;
+template< class S, class R >
+using XContiguous =
+    typename std::enable_if< not IsContiguousArith<S>::value, R >::type;
+
 template< class X, class R > 
 using XInt = typename std::enable_if< !std::is_integral<X>::value, R >::type;
 
@@ -1428,16 +2124,35 @@ std::pair<_S,_S> sbreak( P&& p, S&& s ) {
     return splitAt( cfindIf(forward<P>(p),forward<S>(s)), forward<S>(s) );
 }
 
-template< class P, class S, class _S = Decay<S>, class V = std::vector<_S> >
+/*
+ * splitBy p s -- the pieces of s between runs of elements where (p x).
+ * splitBy_wrap returns the pieces as Ranges over s, so nothing is copied; like
+ * range(s), they must not outlive s.
+ *
+ * A leading separator gives an empty first piece; a trailing one does not
+ * give an empty last piece.
+ */
+template< class P, class S, class I = SeqIter<S>,
+          class V = std::vector< Range<Decay<S>,I> > >
+V splitBy_wrap( P&& p, S&& s ) {
+    V r;
+    I b = begin( s ), e = end( s );
+    while( true ) {
+        I m = std::find_if( b, e, p );
+        r.emplace_back( b, m );
+        b = std::find_if_not( m, e, p );
+        if( b == e )
+            return r;
+    }
+}
+
+template< class P, class S, class _S = Decay<S>,
+          class V = VectorLike<_S,_S> >
 V splitBy( P&& p, S&& s ) {
-    _S low, high;
-    std::tie(low,high) = sbreak( forward<P>(p), forward<S>(s) );
-    high = dropWhile( forward<P>(p), move(high) );
-
-    V r{ move(low) };
-    return null(high) ? r
-        : append( move(r), 
-                  splitBy( forward<P>(p), move(high) ) );
+    V r;
+    for( const auto& piece : splitBy_wrap( forward<P>(p), s ) )
+        r.emplace_back( piece.b, piece.e );
+    return r;
 }
 
 template< class P,
@@ -1490,9 +2205,24 @@ constexpr struct Elem : Binary<Elem> {
     using Binary<Elem>::operator();
 
     template< class X, class S >
-    bool operator () ( const X& x, const S& s ) const {
+    XContiguous<S,bool> operator () ( const X& x, const S& s ) const {
         return std::find( begin(s), end(s), x ) != end(s);
     }
+
+    template< class X, class S >
+    EContiguous<S,bool> operator () ( const X& x, const S& s ) const {
+        return simd::elem( x, s.data(), s.size() );
+    }
+
+    template< class X, class I >
+    constexpr bool operator () ( const X& x, XRange<I> r ) const {
+        return progression::contains( r, x );
+    }
+
+    template< class P, class X, class S >
+    EPolicy<P,bool> operator () ( const P& p, const X& x, const S& s ) const {
+        return p.elem( x, s );
+    }
 } elem{};
 
 constexpr auto notElem = fnot( elem );
@@ -1519,7 +2249,7 @@ V elemIndecies( const X& x, const S& s ) {
 template< class X, class S >
 S nubInsert( X&& x, S s ) {
     auto it = std::lower_bound( begin(s), end(s), forward<X>(x) );
-    if( *it != x )
+    if( it == end(s) or *it != x )
         s.insert( it, forward<X>(x) );
     return s;
 }
@@ -1605,16 +2335,52 @@ S consWhen( bool b, S s, X&& x ) {
     return b ? cons( move(s), forward<X>(x) ) : s;
 }
 
+/*
+ * Can the elements of XS and YS be put in a hash::Table? They must be of the
+ * same hashable type and be stored in the sequence (not made by the iterator,
+ * like an XRange's are).
+ */
+template< class XS, class YS, class X = SeqVal<XS> >
+struct CanHashT : std::integral_constant < bool,
+    hash::IsHashable<X>::value
+    and std::is_same< X, SeqVal<YS> >::value
+    and std::is_lvalue_reference< SeqRef<const XS> >::value
+    and std::is_lvalue_reference< SeqRef<const YS> >::value
+>
+{
+};
+
+template< class XS, class YS >
+using CanHash = CanHashT< Decay<XS>, Decay<YS> >;
+
+template< class XS, class YS, class R >
+using EHash = typename std::enable_if< CanHash<XS,YS>::value, R >::type;
+template< class XS, class YS, class R >
+using XHash = typename std::enable_if< not CanHash<XS,YS>::value, R >::type;
+
+/* nub s -- s, sorted, without duplicates. */
 template< class S >
-S nub( S s ) {
+XHash<S,S,S> nub( S s ) {
     s = sort( move(s) );
     auto e = std::unique( begin(s), end(s) );
     s.erase( e, end(s) );
     return s;
 }
 
+template< class S >
+EHash<S,S,S> nub( const S& s ) {
+    using X = SeqVal<S>;
+    hash::Table<X> t( length(s) );
+    S r;
+    for( const X& x : s )
+        if( t.insert(x) )
+            cons_( r, x );
+    return sort( move(r) );
+}
+
+/* difference xs ys -- every x in xs where notElem x ys. */
 template< class XS, class YS, class R = Decay<XS> >
-R difference( XS&& xs, const YS& ys ) {
+XHash<XS,YS,R> difference( XS&& xs, const YS& ys ) {
     using F = R(*)( const YS&, XS, SeqRef<XS> );
     return list::foldl ( 
         closure( (F)consDifference, ys ),
@@ -1622,18 +2388,68 @@ R difference( XS&& xs, const YS& ys ) {
     );
 }
 
+template< class XS, class YS, class R = Decay<XS> >
+EHash<XS,YS,R> difference( const XS& xs, const YS& ys ) {
+    using X = SeqVal<XS>;
+    R r;
+    if( length(ys) <= length(xs) ) {
+        auto t = hash::table<X>( ys );
+        for( const X& x : xs )
+            if( not t.count(x) )
+                cons_( r, x );
+    } else {
+        // Table the smaller side and strike out what ys has.
+        auto t = hash::table<X>( xs );
+        for( const X& y : ys )
+            t.remove( y );
+        for( const X& x : xs )
+            if( t.count(x) )
+                cons_( r, x );
+    }
+    return r;
+}
+
+/*
+ * sunion xs ys -- xs with each y that it lacks.
+ * If xs is sorted, so is the result.
+ */
 constexpr struct Union : Chainable<Union> {
     using Chainable<Union>::operator();
 
     template< class XS, class YS >
-    XS operator () ( XS xs, YS&& ys ) const {
+    XHash<XS,YS,XS> operator () ( XS xs, YS&& ys ) const {
         using F = XS(*)( XS, SeqRef<YS> );
         return foldl( (F)consSet, move(xs), forward<YS>(ys) );
     }
+
+    template< class XS, class YS >
+    EHash<XS,YS,XS> operator () ( const XS& xs, const YS& ys ) const {
+        // Where xs isn't sorted, inserting in order means something else.
+        if( not std::is_sorted( begin(xs), end(xs) ) ) {
+            using F = XS(*)( XS, SeqRef<YS> );
+            return foldl( (F)consSet, xs, ys );
+        }
+
+        using X = SeqVal<XS>;
+        std::vector<X> ns; // The new elements.
+        {
+            auto t = hash::table<X>( xs );
+            for( const X& y : ys )
+                if( t.insert(y) )
+                    ns.push_back( y );
+        }
+        std::sort( begin(ns), end(ns) );
+
+        XS r;
+        std::merge( begin(xs), end(xs), begin(ns), end(ns),
+                    tailInserter(r) );
+        return r;
+    }
 } sunion{};
 
+/* intersect xs ys -- every x in xs where elem x ys. */
 template< class XS, class YS, class R = Decay<XS> >
-R intersect( XS&& xs, const YS& ys ) {
+XHash<XS,YS,R> intersect( XS&& xs, const YS& ys ) {
     using F = R(*)( const YS&, XS, SeqRef<XS> );
     return list::foldl (
         closure( (F)consIntersection, ys ),
@@ -1641,49 +2457,165 @@ R intersect( XS&& xs, const YS& ys ) {
     );
 }
 
+template< class XS, class YS, class R = Decay<XS> >
+EHash<XS,YS,R> intersect( const XS& xs, const YS& ys ) {
+    using X = SeqVal<XS>;
+    R r;
+    if( length(ys) <= length(xs) ) {
+        auto t = hash::table<X>( ys );
+        for( const X& x : xs )
+            if( t.count(x) )
+                cons_( r, x );
+    } else {
+        // Table the smaller side and strike out what ys has.
+        auto t = hash::table<X>( xs );
+        for( const X& y : ys )
+            t.remove( y );
+        for( const X& x : xs )
+            if( not t.count(x) )
+                cons_( r, x );
+    }
+    return r;
+}
+
+/*
+ * The intersection of two progressions is another, found by the Chinese
+ * remainder theorem rather than by comparing elements. In xs's order.
+ */
+template< class I >
+XRange<I> intersect( XRange<I> xs, XRange<I> ys ) {
+    // An empty range's highest() is one stride past its front, which wraps
+    // for unsigned I; clip needs real bounds.
+    if( xs.empty() or ys.empty() )
+        return XRange<I>( xs.front(), xs.front(), xs.stride );
+    return progression::orderedLike( xs, progression::clip (
+        progression::congruent( xs.lowest(), xs.step(), xs.size(),
+                                ys.lowest(), ys.step() ),
+        ys.lowest(), ys.highest()
+    ) );
+}
+
 constexpr struct Sum {
     template< class S >
-    constexpr SeqVal<S> operator() ( const S& s ) {
+    constexpr XContiguous<S,SeqVal<S>> operator() ( const S& s ) {
         return list::foldl( Add(), SeqVal<S>(0), s );
     }
 
+    template< class S >
+    EContiguous<S,SeqVal<S>> operator() ( const S& s ) const {
+        return simd::sum( s.data(), s.size() );
+    }
+
     template< class I >
     constexpr I operator() ( XRange<I> r ) {
-        // sum [m,n] = (n + 1 - m)(n + m)/2
-        return (*r.e - *r.b) * (*r.e - 1 + *r.b) / 2;
+        // sum [a, a+d .. a+(n-1)d] = n*a + d*n(n-1)/2
+        return I( r.size() ) * r.front()
+             + r.stride * I( r.size() * (r.size() - 1) / 2 );
     }
 } sum{};
 
 constexpr struct Product {
     template< class S >
-    constexpr SeqVal<S> operator () ( const S& s ) {
+    constexpr XContiguous<S,SeqVal<S>> operator () ( const S& s ) {
         return list::foldl( Mult(), SeqVal<S>(1), s );
     }
+
+    template< class S >
+    EContiguous<S,SeqVal<S>> operator () ( const S& s ) const {
+        return simd::product( s.data(), s.size() );
+    }
 } product{};
 
+/*
+ * maximum s -- the greatest element of s; s must not be empty.
+ * For vectors and arrays of numbers, returns a copy, not a reference.
+ */
 constexpr struct Maximum {
     template< class S >
-    SeqRef<S> operator () ( S&& s ) const {
+    XContiguous<S,SeqRef<S>> operator () ( S&& s ) const {
         return *std::max_element( begin(forward<S>(s)), end(forward<S>(s)) );
     }
+
+    template< class S >
+    EContiguous<S,SeqVal<S>> operator () ( const S& s ) const {
+        return simd::maximum( s.data(), s.size() );
+    }
+
+    template< class I >
+    constexpr I operator () ( XRange<I> r ) const {
+        return r.highest();
+    }
 } maximum{};
 
+constexpr struct Minimum {
+    template< class S >
+    XContiguous<S,SeqRef<S>> operator () ( S&& s ) const {
+        return *std::min_element( begin(forward<S>(s)), end(forward<S>(s)) );
+    }
+
+    template< class S >
+    EContiguous<S,SeqVal<S>> operator () ( const S& s ) const {
+        return simd::minimum( s.data(), s.size() );
+    }
+
+    template< class I >
+    constexpr I operator () ( XRange<I> r ) const {
+        return r.lowest();
+    }
+} minimum{};
+
+/* minmax s = (minimum s, maximum s) -- in one pass. */
+constexpr struct MinMax {
+    template< class S, class X = SeqVal<S> >
+    XContiguous<S,std::pair<X,X>> operator () ( const S& s ) const {
+        auto mm = std::minmax_element( begin(s), end(s) );
+        return std::make_pair( *mm.first, *mm.second );
+    }
+
+    template< class S, class X = SeqVal<S> >
+    EContiguous<S,std::pair<X,X>> operator () ( const S& s ) const {
+        return simd::minmax( s.data(), s.size() );
+    }
+} minmax{};
+
 constexpr struct All : Binary<All> {
     using Binary<All>::operator();
 
     template< class F, class S >
-    bool operator () ( F&& f, const S& s ) const {
+    XContiguous<S,bool> operator () ( F&& f, const S& s ) const {
         return std::all_of( begin(s), end(s), forward<F>(f) );
     }
+
+    template< class F, class S >
+    EContiguous<S,bool> operator () ( F&& f, const S& s ) const {
+        Decay<F> g = forward<F>(f); // Like std::all_of, which takes a copy.
+        return simd::all( g, s.data(), s.size() );
+    }
+
+    template< class P, class F, class S >
+    EPolicy<P,bool> operator () ( const P& p, F&& f, const S& s ) const {
+        return p.all( forward<F>(f), s );
+    }
 } all{};
 
 constexpr struct Any : Binary<Any> {
     using Binary<Any>::operator();
 
     template< class F, class S >
-    bool operator () ( F&& f, const S& s ) const {
+    XContiguous<S,bool> operator () ( F&& f, const S& s ) const {
         return any_of( begin(s), end(s), forward<F>(f) );
     }
+
+    template< class F, class S >
+    EContiguous<S,bool> operator () ( F&& f, const S& s ) const {
+        Decay<F> g = forward<F>(f); // Like std::any_of, which takes a copy.
+        return simd::any( g, s.data(), s.size() );
+    }
+
+    template< class P, class F, class S >
+    EPolicy<P,bool> operator () ( const P& p, F&& f, const S& s ) const {
+        return p.any( forward<F>(f), s );
+    }
 } any{};
 
 constexpr struct None : Binary<None> {
@@ -1693,6 +2625,11 @@ constexpr struct None : Binary<None> {
     bool operator () ( F&& f, const S& s ) const {
         return std::none_of( begin(s), end(s), forward<F>(f) );
     }
+
+    template< class P, class F, class S >
+    EPolicy<P,bool> operator () ( const P& p, F&& f, const S& s ) const {
+        return p.none( forward<F>(f), s );
+    }
 } none{};
 
 template< class F, class XS, class YS >
@@ -1717,7 +2654,7 @@ constexpr XS maybeConsRange( XS xs, YS&& ys ) {
 }
 
 template< class S, class P = std::equal_to<SeqRef<S>>,
-          class _S = Decay<S>, class V = std::vector<_S> >
+          class _S = Decay<S>, class V = VectorLike<_S,_S> >
 V group( S&& s, P&& p = P() ) {
     V v;
 
@@ -1740,33 +2677,54 @@ V group( S&& s, P&& p = P() ) {
     return v;
 }
 
-constexpr struct Inits {
-    template< class S, class V = std::vector<S> >
-    static V _inits( const S& s ) {
-        V v;
-        for( auto it = begin(s); it != end(s); it++ )
-            v.emplace_back( begin(s), it );
+/*
+ * inits s -- [], [s0], [s0,s1], ... every prefix of s, shortest first, but s.
+ * tails s -- [], [sn], [sn-1,sn], ... every suffix of s, shortest first.
+ * Both give [] for an empty s.
+ *
+ * inits_wrap and tails_wrap return each piece as a Range over s, so they
+ * cost O(n) in total rather than copying O(n^2) elements; like range(s),
+ * the pieces must not outlive s. dup a piece to own it.
+ */
+template< class S, class I = SeqIter<S>,
+          class V = std::vector< Range<Decay<S>,I> > >
+V inits_wrap( S&& s ) {
+    V v;
+    for( I it = begin(s); it != end(s); it++ )
+        v.emplace_back( begin(s), it );
+    return v;
+}
+
+template< class S, class I = SeqIter<S>,
+          class V = std::vector< Range<Decay<S>,I> > >
+V tails_wrap( S&& s ) {
+    V v;
+    if( null(s) )
         return v;
-    }
 
+    v.emplace_back( end(s), end(s) );
+    for( I it = end(s); it != begin(s); )
+        v.emplace_back( --it, end(s) );
+    return v;
+}
+
+constexpr struct Inits {
     template< class S, class V = std::vector<S> >
     V operator() ( const S& s ) const {
-        return not null(s) ? _inits(s) : V();
+        V v;
+        for( const auto& piece : inits_wrap(s) )
+            v.emplace_back( piece.b, piece.e );
+        return v;
     }
 } inits{};
 
 constexpr struct Tails {
-    template< class S, class V = std::vector<S> >
-    static V _tails( const S& s ) {
-        V v{ S() };
-        for( auto it = end(s); it != begin(s); )
-            v.emplace_back( --it, end(s) );
-        return v;
-    }
-
     template< class S, class V = std::vector<S> >
     V operator() ( const S& s ) const {
-        return not null(s) ? _tails(s) : V();
+        V v;
+        for( const auto& piece : tails_wrap(s) )
+            v.emplace_back( piece.b, piece.e );
+        return v;
     }
 } tails{};
 
@@ -1836,6 +2794,13 @@ constexpr struct ConcatMap : Binary<ConcatMap> {
         }
         return r;
     }
+
+    template< class P, class F, class S >
+    auto operator () ( const P& p, F&& f, const S& xs ) const
+        -> EPolicy< P, decltype( p.concatMap(declval<F>(),xs) ) >
+    {
+        return p.concatMap( forward<F>(f), xs );
+    }
 } concatMap{};
 
 constexpr struct FoldMap : Binary<FoldMap> {
@@ -1869,22 +2834,40 @@ constexpr struct FoldMap : Binary<FoldMap> {
     }
 } foldMap{};
 
+/* r with f(x...) added to its end. */
+template< class F > struct ConsWith {
+    F& f;
+
+    template< class R, class ...X >
+    R operator () ( R r, const X& ...x ) const {
+        cons_( r, f( x... ) );
+        return r;
+    }
+};
+
 /* zipWith f A B -> { f(a,b) for a in A and b in B } */
 template< class F, class R, class ...S >
 R _zipWith( F&& f, R r, const S& ...s ) {
-    return each( notNull, s... ) ?
-        _zipWith( forward<F>(f),
-                   cons( move(r), forward<F>(f)( head(s)... ) ),
-                   tail_wrap( s )... )
-        : r;
+    // A loop, like accuml, rather than recursion on the tails, so that long
+    // sequences don't run out of stack.
+    return accumlIt( ConsWith<F>{ f }, move(r),
+                     std::make_tuple( begin(s)... ),
+                     std::make_tuple( end(s)... ),
+                     tpl::BuildList< sizeof...(S) >() );
 }
 
 constexpr struct ZipWith {
-    template< class F, class XS, class ...YS, class R = Dup<XS> >
+    template< class F, class XS, class ...YS, class R = XPolicy<F,Dup<XS>> >
     R operator () ( F&& f, const XS& xs, const YS& ...ys ) const {
         return _zipWith( forward<F>(f), R(), xs, ys... );
     }
 
+    template< class P, class F, class XS, class ...YS >
+    auto operator () ( const P& p, F&& f, const XS& xs, const YS& ...ys ) const
+        -> EPolicy< P, decltype( p.zipWith(declval<F>(),xs,ys...) ) >
+    {
+        return p.zipWith( forward<F>(f), xs, ys... );
+    }
 
     template< typename S, typename F >
     S operator () ( F&& f, const S& a, S b ) const {
@@ -1899,6 +2882,11 @@ std::vector<Decay<S>> lines( S&& s ) {
     return splitBy( eq('\n'), forward<S>(s) );
 }
 
+template< class S >
+auto lines_wrap( S&& s ) -> decltype( splitBy_wrap(eq('\n'),declval<S>()) ) {
+    return splitBy_wrap( eq('\n'), forward<S>(s) );
+}
+
 template< class SS, class S = SeqVal<SS> >
 S unlines( const SS& ss ) {
     // Remove the last '\n'.
@@ -1909,9 +2897,21 @@ S unlines( const SS& ss ) {
 }
 
 #include <cctype>
+/* std::isspace, safe for any char: a negative one is undefined behaviour. */
+constexpr struct IsSpace {
+    bool operator () ( char c ) const {
+        return std::isspace( (unsigned char) c );
+    }
+} isSpace{};
+
 template< class S >
 std::vector<Decay<S>> words( S&& s ) {
-    return splitBy( isspace, forward<S>(s) );
+    return splitBy( isSpace, forward<S>(s) );
+}
+
+template< class S >
+auto words_wrap( S&& s ) -> decltype( splitBy_wrap(isSpace,declval<S>()) ) {
+    return splitBy_wrap( isSpace, forward<S>(s) );
 }
 
 template< class SS, class S = SeqVal<SS> >
@@ -1941,6 +2941,19 @@ constexpr V_ V( X&& x, Y&& ...y ) {
     }; 
 }
 
+/*
+ * SV(x,y...) holds just x,y...; SV<N>(x,y...) has room for N. Either is a
+ * StaticVec, on the stack.
+ */
+template< size_t N = 0, class X, class ...Y,
+          class SV_ = StaticVec< Decay<X>, N ? N : 1 + sizeof...(Y) > >
+SV_ SV( X&& x, Y&& ...y ) {
+    return {
+        std::forward<X>(x),
+        std::forward<Y>(y)...
+    };
+}
+
 template< class X, class ...Y, class L_ = std::list<Decay<X>> >
 constexpr L_ L( X&& x, Y&& ...y ) {
     return {
@@ -103,12 +103,16 @@ struct Functor< maybe_type > {
      * f <$> Just x = Just (f x)
      * f <$> Nothing = Nothing
      */
-    template< class F, class ...M >
-    static constexpr auto fmap( F&& f, M&& ...m ) 
-        -> decltype( data::Just(declval<F>()( *declval<M>()... )) )
+    template< class F, class M, class ...Ms,
+              class R = data::JustLike< M, decltype (
+                  declval<F>()( *declval<M>(), *declval<Ms>()... )
+              ) > >
+    static constexpr R fmap( F&& f, M&& m, Ms&& ...ms ) 
     {
-        return each( forward<M>(m)... ) ? 
-            data::Just( forward<F>(f)( *forward<M>(m)... ) ) : nullptr;
+        return each( m, ms... ) ?
+            data::justLike<M>( forward<F>(f)( *forward<M>(m),
+                                              *forward<Ms>(ms)... ) )
+            : nullptr;
     }
 };
 
@@ -124,10 +128,33 @@ struct Functor< category::sequence_type > {
 
 template< class L, class R >
 struct Functor< data::Either<L,R> > {
-    template< class F, class FR = decltype( declval<F>()(declval<R>()) ) >
+    template< class F, class FR = Result<F,R> >
     static data::Either<L,FR>  fmap( F&& f, const data::Either<L,R>& e ) {
-        return e.right ? data::Right<L>( forward<F>(f)(*e.right) ) 
-                       : data::Left<FR>( *e.left );
+        return e.right() ? data::Right<L>( forward<F>(f)(*e.right()) ) 
+                         : data::Left<FR>( *e.left() );
+    }
+
+    /* When f keeps the type, the result reuses e. */
+    template< class F, class FR = Result<F,R> >
+    static data::Either<L,FR>  fmap( F&& f, data::Either<L,R>&& e ) {
+        return fmapMove( forward<F>(f), move(e), std::is_same<R,FR>() );
+    }
+
+    template< class F >
+    static data::Either<L,R> fmapMove( F&& f, data::Either<L,R>&& e,
+                                       std::true_type )
+    {
+        if( e.right() )
+            *e.right() = forward<F>(f)( move(*e.right()) );
+        return move( e );
+    }
+
+    template< class F, class FR = Result<F,R> >
+    static data::Either<L,FR> fmapMove( F&& f, data::Either<L,R>&& e,
+                                        std::false_type )
+    {
+        return e.right() ? data::Right<L>( forward<F>(f)(move(*e.right())) )
+                         : data::Left<FR>( move(*e.left()) );
     }
 };
 
@@ -140,6 +167,14 @@ struct Functor< data::Either<L,R> > {
  *
  *   a >>  b = mdo   a b
  *   m >>= f = mbind m f
+ *
+ * foldM and sequence, written with >>=, recurse once per element. A Monad may
+ * instead give them a loop of its own by defining either of
+ *   template< class R, class B, class X, class S >
+ *   static R foldM( B&& b, X&& x, const S& s );  -- R = M y
+ *   template< class R, class S >
+ *   static R sequence( const S& s );             -- s = [M x], R = M [x]
+ * The Maybe, Either and sequence instances do.
  */
 template< class ...M > struct Monad;
 
@@ -241,8 +276,9 @@ template<> struct Monad< category::sequence_type > {
         //      [] >> k = []
         YS c;
         auto size = list::length( a );
+        list::reserve_( c, size * list::length(b) );
         while( size-- )
-            c = list::append( move(c), b );
+            list::append_( c, b );
         return c;
     }
 
@@ -252,6 +288,36 @@ template<> struct Monad< category::sequence_type > {
     {
         return list::concatMap( forward<F>(f), s );
     }
+
+    /* Breadth first: each step applies b to every accumulator so far. */
+    template< class R, class B, class X, class S >
+    static R foldM( B&& b, X&& x, const S& s ) {
+        R accs = mreturn<R>( forward<X>(x) );
+        for( const auto& y : s ) {
+            R next;
+            for( auto& acc : accs )
+                list::append_( next, b( move(acc), y ) );
+            accs = move( next );
+            if( list::null(accs) )
+                break;
+        }
+        return accs;
+    }
+
+    /* sequence [xs,ys...] = [ x:y:... | x <- xs, y <- ys... ] */
+    template< class R, class SS >
+    static R sequence( const SS& sxs ) {
+        R r{ list::SeqVal<R>() };
+        for( const auto& xs : sxs ) {
+            R next;
+            list::reserve_( next, list::length(r) * list::length(xs) );
+            for( const auto& p : r )
+                for( const auto& x : xs )
+                    list::cons_( next, list::_cons(p, x) );
+            r = move( next );
+        }
+        return r;
+    }
 };
 
 template< class P > struct IsPointerImpl { 
@@ -266,7 +332,7 @@ template<> struct Monad< maybe_type > {
 
     template< class M, class X, class P = smart_ptr<M> >
     static P mreturn( X&& x ) {
-        return P( new Decay<X>(forward<X>(x)) );
+        return data::justLike<P>( forward<X>(x) );
     }
 
     template< class M >
@@ -291,6 +357,98 @@ template<> struct Monad< maybe_type > {
     static constexpr Result<M,F> mbind( F&& f, M&& m ) {
         return m ? forward<F>(f)( *forward<M>(m) ) : nullptr;
     }
+
+    /* Stops at the first Nothing. */
+    template< class R, class B, class X, class S >
+    static R foldM( B&& b, X&& x, const S& s ) {
+        auto it = std::begin( s ), e = std::end( s );
+        if( it == e )
+            return mreturn<R>( forward<X>(x) );
+
+        R acc = b( forward<X>(x), *it );
+        for( ++it; acc and it != e; ++it )
+            acc = b( *move(acc), *it );
+        return acc;
+    }
+
+    template< class R, class S >
+    static R sequence( const S& s ) {
+        value_type<R> xs;
+        list::reserve_( xs, list::length(s) );
+        for( const auto& mx : s ) {
+            if( not mx )
+                return nullptr;
+            list::cons_( xs, *mx );
+        }
+        return mreturn<R>( move(xs) );
+    }
+};
+
+/*
+ * Right x >>= f = f x
+ * Left  e >>= f = Left e
+ */
+template< class L, class R > struct Monad< data::Either<L,R> > {
+    using E = data::Either<L,R>;
+
+    template< class M, class X >
+    static M mreturn( X&& x ) {
+        return M( typename M::Right( forward<X>(x) ) );
+    }
+
+    template< class M >
+    static M mfail( const char* why ) {
+        return M( typename M::Left( why ) );
+    }
+
+    template< class B, class _B = Decay<B> >
+    static _B mdo( const E& a, B&& b ) {
+        return a.right() ? forward<B>(b)
+                         : _B( typename _B::Left( *a.left() ) );
+    }
+
+    template< class B, class _B = Decay<B> >
+    static _B mdo( E&& a, B&& b ) {
+        return a.right() ? forward<B>(b)
+                         : _B( typename _B::Left( move(*a.left()) ) );
+    }
+
+    template< class F, class Y = Result< F, const R& > >
+    static Y mbind( F&& f, const E& m ) {
+        return m.right() ? forward<F>(f)( *m.right() )
+                         : Y( typename Y::Left( *m.left() ) );
+    }
+
+    template< class F, class Y = Result< F, R&& > >
+    static Y mbind( F&& f, E&& m ) {
+        return m.right() ? forward<F>(f)( move(*m.right()) )
+                         : Y( typename Y::Left( move(*m.left()) ) );
+    }
+
+    /* Stops at the first Left. */
+    template< class M, class B, class X, class S >
+    static M foldM( B&& b, X&& x, const S& s ) {
+        auto it = std::begin( s ), e = std::end( s );
+        if( it == e )
+            return mreturn<M>( forward<X>(x) );
+
+        M acc = b( forward<X>(x), *it );
+        for( ++it; acc.right() and it != e; ++it )
+            acc = b( move(*acc.right()), *it );
+        return acc;
+    }
+
+    template< class M, class S >
+    static M sequence( const S& s ) {
+        typename M::right_type xs;
+        list::reserve_( xs, list::length(s) );
+        for( const E& e : s ) {
+            if( not e.right() )
+                return M( typename M::Left( *e.left() ) );
+            list::cons_( xs, *e.right() );
+        }
+        return mreturn<M>( move(xs) );
+    }
 };
 
 /*
@@ -353,9 +511,28 @@ constexpr struct LiftCons {
  * sequence [[1,2],[3,4]] = [[1,3],[2,4]]
  */
 constexpr struct Sequence {
+    // Use the Monad's own loop, if it has one.
+    template< class R, class XS, class SM,
+              class Mo = Monad<Cat<list::SeqVal<SM>>> >
+    static auto run( int, const SM& smx )
+        -> decltype( Mo::template sequence<R>(smx) )
+    {
+        return Mo::template sequence<R>( smx );
+    }
+
+    template< class R, class XS, class SM >
+    static R run( long, const SM& smx ) {
+        return list::foldl( liftCons, mreturn<R>(XS{}), smx );
+    }
+
     template< template<class...> class S, template<class...> class M, class X >
     constexpr M<S<X>> operator () ( const S<M<X>>& smx ) {
-        return list::foldl( liftCons, mreturn<M>(S<X>{}), smx );
+        return run< M<S<X>>, S<X> >( 0, smx );
+    }
+
+    template< template<class...> class S, class L, class X >
+    data::Either<L,S<X>> operator () ( const S<data::Either<L,X>>& smx ) const {
+        return run< data::Either<L,S<X>>, S<X> >( 0, smx );
     }
 } sequence{};
 
@@ -407,7 +584,8 @@ template<> struct MonadPlus< category::maybe_type > {
 
     template< class P >
     static constexpr P mplus( const P& a, const P& b ) {
-        return a ? data::Just(*a) : data::Just(*b);;
+        return a ? data::justLike<P>(*a)
+             : b ? data::justLike<P>(*b) : nullptr;
     }
 
     template< class P >
@@ -523,13 +701,24 @@ constexpr struct FoldM {
         }
     } do_fold{};
 
+    // Use the Monad's own loop, if it has one.
+    template< class R, class B, class I, class S, class Mo = Monad<Cat<R>> >
+    static auto run( int, B&& b, I&& i, const S& s )
+        -> decltype( Mo::template foldM<R>(declval<B>(),declval<I>(),s) )
+    {
+        return Mo::template foldM<R>( forward<B>(b), forward<I>(i), s );
+    }
+
+    template< class R, class B, class I, class S >
+    static R run( long, B&& b, I&& i, const S& s ) {
+        return DoFold() ( forward<B>(b), list::range(s), forward<I>(i) );
+    }
+
     template< class Binary, class Init, class S,
               class R = Result< Binary, Init, Result<list::Head,S> > >
     R operator () ( Binary&& b, Init&& i, const S& s ) const
     {
-        return DoFold() (
-            forward<Binary>(b), list::range(s), forward<Init>(i)
-        );
+        return run<R>( 0, forward<Binary>(b), forward<Init>(i), s );
     }
 } foldM{};
 
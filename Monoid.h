@@ -86,7 +86,7 @@ template<> struct Monoid< category::maybe_type > {
 
     template< class M >
     static M dup( const M& m ) {
-        return m ? Just(*m) : nullptr;
+        return m ? data::justLike<M>(*m) : nullptr;
     }
 
     template< class X >
@@ -103,7 +103,7 @@ template<> struct Monoid< category::maybe_type > {
      */
     template< class M >
     static constexpr Decay<M> mappend( M&& x, M&& y ) {
-        return x and y ? Just( *forward<M>(x) + *forward<M>(y) )
+        return x and y ? data::justLike<M>( *forward<M>(x) + *forward<M>(y) )
             : x ? dup(forward<M>(x)) : dup(forward<M>(y));
     }
 
@@ -118,6 +118,7 @@ template<> struct Monoid< category::maybe_type > {
 template< class X, class Y > struct Monoid< std::pair<X,Y> > {
     typedef std::pair<X,Y> P;
 
+    template< class _ = P >
     static P mempty() { return P( monoid::mempty<X>(), monoid::mempty<Y>() ); }
 
     static P mappend( const P& a, const P& b ) {
@@ -254,7 +255,7 @@ constexpr Product operator * ( Product a, Product b ) {
 
 template<> struct Monoid< Product > {
     template< class _ >
-    static constexpr Sum mempty() { return 0; }
+    static constexpr Product mempty() { return 1; }
     static constexpr auto mappend = mult;
     static constexpr auto mconcat = list::product;
 };
@@ -0,0 +1,803 @@
+#pragma once
+
+#include "Pure.h"
+#include "Monoid.h"
+#include "Lazy.h"
+#include "tpl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace pure {
+
+/*
+ * Data-parallel folds.
+ *
+ * A monoid promises that mappend is associative, so
+ *      mconcat [a,b,c,d] = (a <> b) <> (c <> d)
+ * and each pair in parentheses can be computed on its own thread. The
+ * functions here split a random-access sequence into a run per core, unless
+ * the runs would be small, reduce each run sequentially as a task on the
+ * shared Pool, and mappend the results in order. Neighbours are only ever
+ * combined left to right, so non-commutative monoids (Dual, sequences) give
+ * the same answer as the sequential fold.
+ *
+ * Sequences without random access iterators can't be split cheaply; they are
+ * reduced sequentially. The exceptions are lazy::permutations, which splits
+ * by prefix instead of by position, and lazy::cartesian, which splits by rows.
+ *
+ * The execution policies par and par_unseq run map, filter, zipWith, all,
+ * any, none, find, elem, sort, concatMap and vmap on a shared work-stealing
+ * Pool instead; see ParallelPolicy below. fork and fork_ partition a
+ * sequence across the same Pool.
+ *
+ * Requires linking with -pthread.
+ */
+namespace parallel {
+
+/* The number of threads a reduction splits into. */
+inline unsigned int threads() {
+    static const unsigned int n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+/*
+ * A fixed set of worker threads, each with its own deque of tasks.
+ *
+ * A worker takes new work from the back of its own deque and, when that runs
+ * dry, steals from the front of the others'; a task spawned by a worker goes
+ * on that worker's deque. Idle workers sleep until something is submitted.
+ *
+ * run(n,f) is the only way in: it calls f(0) ... f(n-1), possibly in
+ * parallel, and returns when all have. The calling thread takes indices too,
+ * until none are left, and then sleeps until the rest are done. It only
+ * ever runs its own f, so one run never waits on another's tasks, and since
+ * every index it waits on is already running, run may be called from inside
+ * a task.
+ */
+class Pool {
+    struct Queue {
+        std::mutex m;
+        std::deque< std::function<void()> > tasks;
+    };
+
+    std::vector< std::unique_ptr<Queue> > queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleep;
+    std::condition_variable wake;
+    std::atomic<size_t> pending{0}; // Tasks queued, not yet taken.
+    std::atomic<size_t> next{0};    // Where the next outside task goes.
+    bool stopping = false;
+
+    // The pool and queue of the calling thread, if it's a worker.
+    static const Pool*& current() {
+        static thread_local const Pool* p = nullptr;
+        return p;
+    }
+    static size_t& self() {
+        static thread_local size_t i = 0;
+        return i;
+    }
+
+    bool isWorker() const { return current() == this; }
+
+    /*
+     * One call to run. Each queued task, and the caller, claims the next
+     * index until they run out, so a task may find nothing left to do; it
+     * may also run after run has returned, hence the shared_ptr.
+     */
+    struct Batch {
+        const size_t n;
+        std::atomic<size_t> claimed{0}, left;
+        std::exception_ptr err;
+        std::mutex m;
+        std::condition_variable done;
+
+        explicit Batch( size_t n ) : n(n), left(n) { }
+
+        template< class F >
+        void drain( const F& f ) {
+            for( size_t i; (i = claimed++) < n; ) {
+                try {
+                    f( i );
+                } catch( ... ) {
+                    std::lock_guard<std::mutex> l( m );
+                    if( not err )
+                        err = std::current_exception();
+                }
+                if( --left == 0 ) {
+                    std::lock_guard<std::mutex> l( m );
+                    done.notify_all();
+                }
+            }
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> l( m );
+            done.wait( l, [&]{ return left == 0; } );
+        }
+    };
+
+    void submit( std::function<void()> t ) {
+        size_t q = isWorker() ? self() : next++ % queues.size();
+        {
+            std::lock_guard<std::mutex> l( queues[q]->m );
+            queues[q]->tasks.push_back( std::move(t) );
+        }
+        {
+            std::lock_guard<std::mutex> l( sleep );
+            pending++;
+        }
+        wake.notify_one();
+    }
+
+    /* Run one queued task, if there is one. */
+    bool help() {
+        const size_t n = queues.size();
+        const size_t me = isWorker() ? self() : next % n;
+        std::function<void()> t;
+
+        for( size_t k = 0; k < n and not t; k++ ) {
+            Queue& q = *queues[ (me + k) % n ];
+            std::lock_guard<std::mutex> l( q.m );
+            if( q.tasks.empty() )
+                continue;
+            if( k == 0 and isWorker() ) {
+                t = std::move( q.tasks.back() );
+                q.tasks.pop_back();
+            } else {
+                t = std::move( q.tasks.front() );
+                q.tasks.pop_front();
+            }
+        }
+
+        if( not t )
+            return false;
+        pending--;
+        t();
+        return true;
+    }
+
+    void work( size_t i ) {
+        current() = this;
+        self() = i;
+        while( true ) {
+            if( help() )
+                continue;
+            std::unique_lock<std::mutex> l( sleep );
+            wake.wait( l, [&]{ return stopping or pending > 0; } );
+            if( stopping and pending == 0 )
+                return;
+        }
+    }
+
+  public:
+    explicit Pool( size_t n ) {
+        for( size_t i = 0; i < std::max<size_t>( n, 1 ); i++ )
+            queues.emplace_back( new Queue );
+        for( size_t i = 0; i < n; i++ )
+            workers.emplace_back( [this,i]{ work(i); } );
+    }
+
+    Pool( const Pool& ) = delete;
+    Pool& operator = ( const Pool& ) = delete;
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> l( sleep );
+            stopping = true;
+        }
+        wake.notify_all();
+        for( auto& w : workers )
+            w.join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    /*
+     * f(0), ..., f(n-1), in any order and on any thread. If any throw, the
+     * first exception caught is rethrown here once all have finished.
+     */
+    template< class F >
+    void run( size_t n, const F& f ) {
+        if( n == 0 )
+            return;
+        if( workers.empty() or n == 1 ) {
+            for( size_t i = 0; i < n; i++ )
+                f( i );
+            return;
+        }
+
+        auto b = std::make_shared<Batch>( n );
+        const F* pf = &f;
+
+        // Once every index is claimed, a task never reads pf.
+        for( size_t i = 1; i < n; i++ )
+            submit( [b,pf]{ b->drain( *pf ); } );
+        b->drain( f );
+        b->wait();
+
+        // Take the exception, so a stale task can't be the one to free it.
+        std::exception_ptr err = std::move( b->err );
+        if( err )
+            std::rethrow_exception( err );
+    }
+};
+
+/* The pool the execution policies share: one worker per other core. */
+inline Pool& pool() {
+    static Pool p( threads() - 1 );
+    return p;
+}
+
+/*
+ * A fold isn't split into runs smaller than this; below it, a task and a
+ * mappend cost more than running the run on another thread saves.
+ */
+constexpr size_t MIN_CHUNK = 1 << 14;
+
+/* The sequential base case: f(x) <> f(y) <> ... for each in [b,e). */
+template< class R, class F, class I >
+R reduce( const F& f, I b, const I& e ) {
+    R r = f( *b );
+    for( ++b; b != e; ++b )
+        r = monoid::mappend( std::move(r), f(*b) );
+    return r;
+}
+
+/*
+ * Reduce [b,b+n) in up to threads() runs of at least MIN_CHUNK, one Pool task
+ * each, and mappend the runs' results in order.
+ */
+template< class R, class F, class I >
+R reduceChunks( const F& f, I b, size_t n ) {
+    const size_t k = std::min<size_t>( n / MIN_CHUNK, threads() );
+    if( k < 2 )
+        return reduce<R>( f, b, std::next(b,n) );
+
+    std::vector<R> rs( k, monoid::mempty<R>() );
+    pool().run( k, [&]( size_t c ) {
+        rs[c] = reduce<R>( f, std::next( b, c * n / k ),
+                              std::next( b, (c+1) * n / k ) );
+    } );
+
+    R r = std::move( rs[0] );
+    for( size_t c = 1; c < k; c++ )
+        r = monoid::mappend( std::move(r), std::move(rs[c]) );
+    return r;
+}
+
+template< class R, class F, class S >
+R foldMapImpl( const F& f, const S& s, std::random_access_iterator_tag ) {
+    return reduceChunks<R>( f, begin(s), list::length(s) );
+}
+
+template< class R, class F, class S >
+R foldMapImpl( const F& f, const S& s, std::input_iterator_tag ) {
+    return reduce<R>( f, begin(s), end(s) );
+}
+
+/*
+ * Reduce each of the pieces, in order, splitting them into threads() runs of
+ * neighbours.
+ */
+template< class R, class F, class V >
+R reducePieces( const F& f, const std::vector<V>& pieces ) {
+    const size_t n = pieces.size();
+    const size_t t = std::min<size_t>( threads(), n );
+
+    auto run = [&]( size_t lo, size_t hi ) {
+        R r = reduce<R>( f, begin(pieces[lo]), end(pieces[lo]) );
+        for( size_t i = lo + 1; i < hi; i++ )
+            r = monoid::mappend( std::move(r),
+                                 reduce<R>( f, begin(pieces[i]),
+                                            end(pieces[i]) ) );
+        return r;
+    };
+
+    std::vector<R> rs( t, monoid::mempty<R>() );
+    pool().run( t, [&]( size_t i ) {
+        rs[i] = run( i * n / t, (i+1) * n / t );
+    } );
+
+    R r = std::move( rs[0] );
+    for( size_t i = 1; i < t; i++ )
+        r = monoid::mappend( std::move(r), std::move(rs[i]) );
+    return r;
+}
+
+/*
+ * A permutation view can't be split by position, but it can by prefix: each
+ * thread runs through the orderings that start with its own prefixes.
+ */
+template< class R, class F, class S >
+R foldMapImpl( const F& f, const list::lazy::PermutationView<S>& v ) {
+    // Too few orderings to be worth a thread?
+    size_t count = 1;
+    for( size_t k = list::length(v.from) - v.fixed; k > 1; k-- )
+        if( (count *= k) >= 2 * MIN_CHUNK )
+            break;
+    if( count < 2 * MIN_CHUNK or threads() == 1 )
+        return reduce<R>( f, begin(v), end(v) );
+
+    // More pieces than threads, since the pieces needn't be the same size.
+    return reducePieces<R>( f, v.split( 8 * threads() ) );
+}
+
+/*
+ * A product splits by rows of xs, so that each piece walks its own rows of ys
+ * in order, whether or not either has random access.
+ */
+template< class R, class F, class XS, class YS >
+R foldMapImpl( const F& f, const list::lazy::ProductView<XS,YS>& v ) {
+    const size_t rows = v.rows();
+    if( v.size() < 2 * MIN_CHUNK or threads() == 1 or rows < 2 )
+        return reduce<R>( f, begin(v), end(v) );
+
+    const size_t k = std::min<size_t>( rows, 8 * threads() );
+    std::vector< typename list::lazy::ProductView<XS,YS>::Slice > pieces;
+    pieces.reserve( k );
+    for( size_t i = 0; i < k; i++ )
+        pieces.push_back( v.slice( i * rows / k, (i+1) * rows / k ) );
+    return reducePieces<R>( f, pieces );
+}
+
+/*
+ * foldMap f xs = mconcat (map f xs)
+ * Where f's result is a monoid. Like fold::foldMap, but f and mappend run
+ * concurrently across the threads().
+ */
+constexpr struct FoldMap : Binary<FoldMap> {
+    using Binary<FoldMap>::operator();
+
+    template< class F, class S,
+              class R = Decay<Result<const F&, list::SeqRef<const S>>>,
+              class Tag = typename std::iterator_traits <
+                  list::SeqIter<const S>
+              >::iterator_category >
+    R operator () ( const F& f, const S& s ) const {
+        return list::null(s) ? monoid::mempty<R>()
+            : foldMapImpl<R>( f, s, Tag() );
+    }
+
+    template< class F, class S, class R = Decay<Result<const F&, const S&>> >
+    R operator () ( const F& f,
+                    const list::lazy::PermutationView<S>& v ) const {
+        return foldMapImpl<R>( f, v );
+    }
+
+    template< class F, class XS, class YS,
+              class V = list::lazy::ProductView<XS,YS>,
+              class R = Decay<Result<const F&, typename V::reference>> >
+    R operator () ( const F& f,
+                    const list::lazy::ProductView<XS,YS>& v ) const {
+        return list::null(v) ? monoid::mempty<R>() : foldMapImpl<R>( f, v );
+    }
+} foldMap{};
+
+/* mconcat xs = x0 <> x1 <> ... <> xn, computed in parallel. */
+constexpr struct MConcat {
+    template< class S >
+    Decay<list::SeqRef<const S>> operator () ( const S& s ) const {
+        return foldMap( id, s );
+    }
+} mconcat{};
+
+/* Chunks smaller than this aren't worth a task. */
+constexpr size_t MIN_TASK = 1 << 12;
+
+/*
+ * How many chunks to split n elements into: a few per thread, so that uneven
+ * ones even out through stealing.
+ */
+inline size_t chunks( size_t n ) {
+    return std::max<size_t>( 1,
+        std::min<size_t>( n / MIN_TASK, 4 * threads() ) );
+}
+
+/*
+ * Split [0,n) into chunks(n) contiguous chunks and call f(c,lo,hi) on each,
+ * the cth being [lo,hi), across the pool. Returns the number of chunks.
+ */
+template< class F >
+size_t forChunks( size_t n, const F& f ) {
+    const size_t k = chunks( n );
+    pool().run( k, [&]( size_t c ) {
+        f( c, c * n / k, (c+1) * n / k );
+    } );
+    return k;
+}
+
+template< class S >
+using IsRandomAccess = std::is_base_of <
+    std::random_access_iterator_tag,
+    typename std::iterator_traits< list::SeqIter<const S> >::iterator_category
+>;
+
+template< class ...S > struct AllRandomAccess : std::true_type { };
+
+template< class S, class ...T > struct AllRandomAccess< S, T... >
+    : std::integral_constant < bool,
+        IsRandomAccess<S>::value and AllRandomAccess<T...>::value
+    >
+{
+};
+
+template< class R > struct IsFillableImpl {
+    template< class _R > static auto f( _R& r ) -> decltype (
+        r.resize( 0 ),
+        std::integral_constant < bool,
+            std::is_lvalue_reference< decltype(*begin(r)) >::value
+            and IsRandomAccess<_R>::value
+        >()
+    );
+    template< class _R > static std::false_type f( ... );
+
+    using type = decltype( f<R>( std::declval<R&>() ) );
+};
+
+/*
+ * Can R be sized up front and then written at any index from any thread?
+ * (Not std::vector<bool>: its elements share bytes.)
+ */
+template< class R >
+using IsFillable = typename IsFillableImpl<R>::type;
+
+/* Should a parallel algorithm split s, or leave it to the sequential one? */
+template< class S >
+bool worthSplitting( const S& s ) {
+    return IsRandomAccess<S>::value and threads() > 1
+        and list::length(s) >= 2 * MIN_TASK;
+}
+
+/*
+ * An execution policy: list::map( par, f, xs ) is map( f, xs ), but splits
+ * xs into chunks across the pool(). Each algorithm gives the same result, in
+ * the same order, as its sequential version, which it falls back to when
+ * the input isn't random access or is too small to split.
+ *
+ * f is called concurrently, so must not modify shared state, and may be
+ * called on elements past the one find, any or all stopped at.
+ *
+ * par_unseq additionally lets any, all and elem hand each chunk of a
+ * contiguous array of numbers to the SIMD kernels in Simd.h.
+ */
+template< bool Vectorize >
+struct ParallelPolicy : list::ExecutionPolicy {
+    using Unseq = std::integral_constant< bool, Vectorize >;
+
+    template< class R, class F, class S >
+    static R mapInto( const F& f, const S& s, std::true_type ) {
+        if( not worthSplitting(s) )
+            return list::map( f, s );
+
+        R r;
+        r.resize( list::length(s) );
+        forChunks( r.size(), [&]( size_t, size_t lo, size_t hi ) {
+            auto it = std::next( begin(s), lo );
+            auto o = std::next( begin(r), lo );
+            for( size_t i = lo; i < hi; i++, ++it, ++o )
+                *o = f( *it );
+        } );
+        return r;
+    }
+
+    template< class R, class F, class S >
+    static R mapInto( const F& f, const S& s, std::false_type ) {
+        return list::map( f, s );
+    }
+
+    /* map( par, f, xs ) */
+    template< class F, class S,
+              class R = decltype (
+                  list::map( declval<const F&>(), declval<const S&>() )
+              ) >
+    R map( const F& f, const S& s ) const {
+        return mapInto<R>( f, s, IsFillable<R>() );
+    }
+
+    template< class R, class F, class ...S >
+    static R zipInto( const F& f, std::true_type, const S& ...s ) {
+        const size_t ns[] = { list::length(s)... };
+        const size_t n = *std::min_element( std::begin(ns), std::end(ns) );
+
+        R r;
+        r.resize( n );
+        forChunks( n, [&]( size_t, size_t lo, size_t hi ) {
+            zipChunk( f, std::next(begin(r),lo), hi - lo,
+                      std::next(begin(s),lo)... );
+        } );
+        return r;
+    }
+
+    template< class R, class F, class ...S >
+    static R zipInto( const F& f, std::false_type, const S& ...s ) {
+        return list::zipWith( f, s... );
+    }
+
+    template< class F, class O, class ...I >
+    static void zipChunk( const F& f, O o, size_t n, I ...it ) {
+        for( ; n > 0; n-- ) {
+            *o = f( *it... );
+            ++o;
+            (void) std::initializer_list<int>{ (++it, 0)... };
+        }
+    }
+
+    /* zipWith( par, f, xs, ys... ) */
+    template< class F, class XS, class ...YS,
+              class R = decltype (
+                  list::zipWith( declval<const F&>(), declval<const XS&>(),
+                                 declval<const YS&>()... )
+              ) >
+    R zipWith( const F& f, const XS& xs, const YS& ...ys ) const {
+        using Split = std::integral_constant < bool,
+            IsFillable<R>::value and AllRandomAccess<XS,YS...>::value
+        >;
+        return worthSplitting(xs) ? zipInto<R>( f, Split(), xs, ys... )
+            : list::zipWith( f, xs, ys... );
+    }
+
+    /*
+     * Gather the results of f(chunk, out) for each chunk of s into per-chunk
+     * pieces, then join the pieces in order.
+     */
+    template< class R, class S, class F >
+    static R gather( const S& s, const F& f ) {
+        const size_t n = list::length( s );
+        std::vector<R> pieces( chunks(n) );
+        forChunks( n, [&]( size_t c, size_t lo, size_t hi ) {
+            auto it = std::next( begin(s), lo );
+            for( size_t i = lo; i < hi; i++, ++it )
+                f( *it, pieces[c] );
+        } );
+
+        size_t len = 0;
+        for( const R& p : pieces )
+            len += list::length( p );
+
+        R r = std::move( pieces[0] );
+        list::reserve_( r, len );
+        for( size_t c = 1; c < pieces.size(); c++ )
+            r.insert( end(r), std::make_move_iterator( begin(pieces[c]) ),
+                              std::make_move_iterator( end(pieces[c]) ) );
+        return r;
+    }
+
+    /* filter( par, p, xs ) */
+    template< class F, class S,
+              class R = decltype (
+                  list::filter( declval<const F&>(), declval<const S&>() )
+              ) >
+    R filter( const F& p, const S& s ) const {
+        if( not worthSplitting(s) )
+            return list::filter( p, s );
+        return gather<R>( s, [&]( const list::SeqVal<S>& x, R& out ) {
+            if( p(x) )
+                list::cons_( out, x );
+        } );
+    }
+
+    /* concatMap( par, f, xs ) */
+    template< class F, class S,
+              class R = decltype (
+                  list::concatMap( declval<const F&>(), declval<const S&>() )
+              ) >
+    R concatMap( const F& f, const S& s ) const {
+        if( not worthSplitting(s) )
+            return list::concatMap( f, s );
+        return gather<R>( s, [&]( const list::SeqVal<S>& x, R& out ) {
+            list::append_( out, f(x) );
+        } );
+    }
+
+    /* How many elements to test between checks of whether to stop. */
+    static constexpr size_t BLOCK = 1 << 10;
+
+    template< class F, class S >
+    static bool anyBlock( const F& p, const S& s, size_t lo, size_t hi,
+                          std::true_type )
+    {
+        return simd::any( p, s.data() + lo, hi - lo );
+    }
+
+    template< class F, class S, class Vec >
+    static bool anyBlock( const F& p, const S& s, size_t lo, size_t hi,
+                          Vec )
+    {
+        auto it = std::next( begin(s), lo );
+        for( size_t i = lo; i < hi; i++, ++it )
+            if( p(*it) )
+                return true;
+        return false;
+    }
+
+    /*
+     * Is p true of any element? Every chunk gives up once any other has
+     * found one.
+     */
+    template< class F, class S >
+    static bool anyOf( const F& p, const S& s ) {
+        if( not worthSplitting(s) )
+            return list::any( p, s );
+
+        using Vec = std::integral_constant < bool,
+            Vectorize and list::IsContiguousArith<S>::value
+        >;
+
+        std::atomic<bool> found( false );
+        forChunks( list::length(s), [&]( size_t, size_t lo, size_t hi ) {
+            for( ; lo < hi and not found; lo += BLOCK )
+                if( anyBlock( p, s, lo, std::min(hi, lo + BLOCK), Vec() ) )
+                    found = true;
+        } );
+        return found;
+    }
+
+    /* any( par, p, xs ) */
+    template< class F, class S >
+    bool any( const F& p, const S& s ) const {
+        return anyOf( p, s );
+    }
+
+    /* all( par, p, xs ) */
+    template< class F, class S >
+    bool all( const F& p, const S& s ) const {
+        return not anyOf( simd::Not<const F>{p}, s );
+    }
+
+    /* none( par, p, xs ) */
+    template< class F, class S >
+    bool none( const F& p, const S& s ) const {
+        return not anyOf( p, s );
+    }
+
+    /* elem( par, x, xs ) */
+    template< class X, class S >
+    bool elem( const X& x, const S& s ) const {
+        return anyOf( simd::EqualTo<X>{x}, s );
+    }
+
+    /* find( par, p, xs ): the first x for which p x, as in list::find. */
+    template< class F, class S,
+              class R = decltype (
+                  list::find( declval<const F&>(), declval<const S&>() )
+              ) >
+    R find( const F& p, const S& s ) const {
+        if( not worthSplitting(s) )
+            return list::find( p, s );
+
+        // The least index found so far. A chunk stops once it's past it.
+        const size_t n = list::length( s );
+        std::atomic<size_t> first( n );
+        forChunks( n, [&]( size_t, size_t lo, size_t hi ) {
+            auto it = std::next( begin(s), lo );
+            for( size_t i = lo; i < hi and i < first; i++, ++it ) {
+                if( p(*it) ) {
+                    size_t f = first;
+                    while( i < f and not first.compare_exchange_weak(f, i) )
+                        ;
+                    return;
+                }
+            }
+        } );
+        return R( std::next(begin(s), first.load()), end(s) );
+    }
+
+    /*
+     * sort( par, xs ): sort each chunk, then merge neighbouring runs
+     * pairwise, each round in parallel, until one run is left.
+     */
+    template< class S >
+    S sort( S s ) const {
+        if( not worthSplitting(s) )
+            return list::sort( std::move(s) );
+
+        const size_t n = list::length( s );
+        const size_t k = forChunks( n, [&]( size_t, size_t lo, size_t hi ) {
+            std::sort( std::next(begin(s),lo), std::next(begin(s),hi) );
+        } );
+
+        // Where forChunks started each chunk.
+        auto at = [&]( size_t c ) { return std::next( begin(s), c * n / k ); };
+
+        for( size_t w = 1; w < k; w *= 2 )
+            pool().run( (k + 2*w - 1) / (2*w), [&]( size_t j ) {
+                size_t lo = 2*w*j, mid = lo + w;
+                if( mid >= k )
+                    return;
+                size_t hi = std::min( mid + w, k );
+                std::inplace_merge( at(lo), at(mid), at(hi) );
+            } );
+        return s;
+    }
+
+    /* vmap( par, f, xs ): f x for each x, for f's side effects. */
+    template< class F, class S >
+    void vmap( const F& f, S&& s ) const {
+        if( not worthSplitting(s) ) {
+            list::vmap( f, std::forward<S>(s) );
+            return;
+        }
+        forChunks( list::length(s), [&]( size_t, size_t lo, size_t hi ) {
+            auto it = std::next( begin(s), lo );
+            for( size_t i = lo; i < hi; i++, ++it )
+                f( *it );
+        } );
+    }
+};
+
+/*
+ * fork_( xs, ps... ) and fork( xs, ps... ) -- tpl::fork_ and tpl::fork, but
+ * each chunk of xs is partitioned on its own, across the pool(), into
+ * resultants of its own and leftovers packed at its front. The leftovers are
+ * then moved down together and the chunks' resultants appended in order, so
+ * the result is the same as the sequential fork's.
+ *
+ * The predicates are called concurrently. Falls back to tpl::fork_ when xs
+ * isn't random access or is too small to split.
+ */
+constexpr struct Fork_ {
+    template< class XS, class ...P,
+              class R = tpl::Fork_::Forked<XS,P...> >
+    R operator () ( XS& xs, const P& ...ps ) const {
+        if( not worthSplitting(xs) )
+            return tpl::fork_( xs, ps... );
+
+        const auto preds = std::forward_as_tuple( ps... );
+        const size_t n = list::length( xs );
+        std::vector<R> pieces( chunks(n) );
+        std::vector<size_t> kept( pieces.size() );
+        forChunks( n, [&]( size_t c, size_t lo, size_t hi ) {
+            auto b = std::next( begin(xs), lo );
+            auto e = tpl::Fork_::partition( b, std::next( begin(xs), hi ),
+                                            pieces[c], preds );
+            kept[c] = size_t( std::distance( b, e ) );
+        } );
+
+        // Chunk c starts at c*n/k, as in forChunks.
+        const size_t k = pieces.size();
+        auto out = std::next( begin(xs), kept[0] );
+        for( size_t c = 1; c < k; c++ ) {
+            auto b = std::next( begin(xs), c * n / k );
+            // Until some chunk drops an element, everything is in place.
+            if( out == b )
+                std::advance( out, kept[c] );
+            else
+                out = std::move( b, std::next( b, kept[c] ), out );
+        }
+        xs.erase( out, end(xs) );
+
+        R r = std::move( pieces[0] );
+        for( size_t c = 1; c < k; c++ )
+            tpl::Fork_::appendEach( r, pieces[c] );
+        return r;
+    }
+} fork_{};
+
+constexpr struct Fork {
+    template< class XS, class ...P,
+              class R = decltype( tpl::repeat<sizeof...(P) + 1>(XS()) ) >
+    R operator () ( XS xs, const P& ...ps ) const {
+        auto forks = fork_( xs, ps... );
+        return tpl::rcons( std::move(forks), std::move(xs) );
+    }
+} fork{};
+
+constexpr ParallelPolicy<false> par{};
+constexpr ParallelPolicy<true>  par_unseq{};
+
+} // namespace parallel
+
+using parallel::par;
+using parallel::par_unseq;
+
+} // namespace pure
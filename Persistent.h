@@ -0,0 +1,325 @@
+#pragma once
+
+#include "List.h"
+
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <initializer_list>
+
+namespace pure {
+
+/*
+ * Persistent sequences.
+ *
+ * The functions in List.h take and return sequences by value: cons s x copies
+ * s before adding x, tail s copies all but the head. For a std::vector that
+ * is O(n) per step. A persistent sequence never changes once built, so a copy
+ * only has to share it; an update copies only the path to what changed.
+ */
+namespace persistent {
+
+/*
+ * Vector X -- a 32-way trie of leaves, plus a tail leaf for the last (up to)
+ * 32 elements. (Like Clojure's vectors.)
+ *
+ *      copy             O(1)
+ *      v[i]             O(log32 n)
+ *      push_back        O(1) into the tail, O(log32 n) once per 32
+ *      tail, init, take, drop, and Vector(b,e) for iterators of a vector
+ *                       O(1); the result shares storage with the original
+ *      cons, append     O(log32 n) per element added
+ *
+ * Since List.h builds tail, init and take through Vector(b,e), and cons and
+ * append through push_back, they all get these costs.
+ *
+ * A Vector views [off,off+len) of its storage. tail and take just narrow the
+ * view, so they keep the whole storage alive, not only what they can see.
+ */
+template< class X > class Vector {
+    static constexpr size_t BITS  = 5;
+    static constexpr size_t WIDTH = 1 << BITS;
+    static constexpr size_t MASK  = WIDTH - 1;
+
+    // A branch has kids; a leaf has xs. Never modified once shared.
+    struct Node {
+        std::vector< std::shared_ptr<const Node> > kids;
+        std::vector<X> xs;
+    };
+
+    using NodeP = std::shared_ptr<const Node>;
+
+    NodeP root;         // Every full leaf, in order.
+    NodeP tl;           // The last, possibly partial, leaf.
+    size_t shift = BITS; // The bits of an index that select root's kid.
+    size_t cnt = 0;     // Elements stored in root and tl.
+    size_t off = 0;     // The first element viewed.
+    size_t len = 0;     // The number of elements viewed.
+
+    // Elements stored before tl.
+    size_t tailOff() const {
+        return cnt < WIDTH ? 0 : ((cnt - 1) >> BITS) << BITS;
+    }
+
+    // The leaf holding storage index i.
+    const Node* leafFor( size_t i ) const {
+        if( i >= tailOff() )
+            return tl.get();
+        const Node* n = root.get();
+        for( size_t level = shift; level > 0; level -= BITS )
+            n = n->kids[ (i >> level) & MASK ].get();
+        return n;
+    }
+
+    static NodeP newPath( size_t level, NodeP n ) {
+        if( level == 0 )
+            return n;
+        auto b = std::make_shared<Node>();
+        b->kids.push_back( newPath( level - BITS, std::move(n) ) );
+        return b;
+    }
+
+    // A copy of parent with leaf added as the last leaf under it.
+    NodeP pushTail( size_t level, const Node* parent, NodeP leaf ) const {
+        auto b = parent ? std::make_shared<Node>( *parent )
+                        : std::make_shared<Node>();
+        size_t i = ( (cnt - 1) >> level ) & MASK;
+        if( b->kids.size() <= i )
+            b->kids.resize( i + 1 );
+
+        if( level == BITS )
+            b->kids[i] = std::move( leaf );
+        else if( b->kids[i] )
+            b->kids[i] = pushTail( level - BITS, b->kids[i].get(),
+                                   std::move(leaf) );
+        else
+            b->kids[i] = newPath( level - BITS, std::move(leaf) );
+        return b;
+    }
+
+    // A copy of n (at level) with storage index i set to x.
+    static NodeP assoc( size_t level, const Node* n, size_t i, X x ) {
+        auto c = std::make_shared<Node>( *n );
+        if( level == 0 )
+            c->xs[ i & MASK ] = std::move( x );
+        else {
+            size_t k = ( i >> level ) & MASK;
+            c->kids[k] = assoc( level - BITS, n->kids[k].get(), i,
+                                std::move(x) );
+        }
+        return c;
+    }
+
+    // Add x to the end of storage.
+    void conj( X x ) {
+        if( cnt - tailOff() < WIDTH ) {
+            auto t = tl ? std::make_shared<Node>( *tl )
+                        : std::make_shared<Node>();
+            t->xs.push_back( std::move(x) );
+            tl = std::move( t );
+        } else {
+            // tl is full; move it into the trie.
+            if( (cnt >> BITS) > (size_t(1) << shift) ) {
+                auto r = std::make_shared<Node>();
+                r->kids.push_back( root );
+                r->kids.push_back( newPath(shift, tl) );
+                root = std::move( r );
+                shift += BITS;
+            } else {
+                root = pushTail( shift, root.get(), tl );
+            }
+
+            auto t = std::make_shared<Node>();
+            t->xs.push_back( std::move(x) );
+            tl = std::move( t );
+        }
+        cnt++;
+    }
+
+    // Set storage index i to x.
+    void set_( size_t i, X x ) {
+        if( i >= tailOff() ) {
+            auto t = std::make_shared<Node>( *tl );
+            t->xs[ i & MASK ] = std::move( x );
+            tl = std::move( t );
+        } else {
+            root = assoc( shift, root.get(), i, std::move(x) );
+        }
+    }
+
+  public:
+    using value_type      = X;
+    using reference       = const X&;
+    using const_reference = const X&;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    /* Reads each element in order, finding each leaf once. */
+    struct const_iterator
+        : std::iterator< std::random_access_iterator_tag, X,
+                         std::ptrdiff_t, const X*, const X& >
+    {
+        const Vector* v = nullptr;
+        size_t i = 0; // The index in v.
+
+        mutable const Node* leaf = nullptr;
+        mutable size_t base = 0; // The storage index of leaf's first x.
+
+        const_iterator() { }
+        const_iterator( const Vector* v, size_t i ) : v(v), i(i) { }
+
+        const X& operator* () const {
+            size_t s = v->off + i;
+            if( not leaf or s < base or s >= base + WIDTH ) {
+                leaf = v->leafFor( s );
+                base = s & ~MASK;
+            }
+            return leaf->xs[ s - base ];
+        }
+        const X* operator-> () const { return &**this; }
+        const X& operator[] ( std::ptrdiff_t n ) const {
+            return *(*this + n);
+        }
+
+        const_iterator& operator++ () { i++; return *this; }
+        const_iterator& operator-- () { i--; return *this; }
+        const_iterator operator++ (int) { auto c = *this; i++; return c; }
+        const_iterator operator-- (int) { auto c = *this; i--; return c; }
+
+        const_iterator& operator+= ( std::ptrdiff_t n ) {
+            i += n;
+            return *this;
+        }
+        const_iterator& operator-= ( std::ptrdiff_t n ) {
+            i -= n;
+            return *this;
+        }
+
+        const_iterator operator+ ( std::ptrdiff_t n ) const {
+            auto c = *this;
+            return c += n;
+        }
+        const_iterator operator- ( std::ptrdiff_t n ) const {
+            auto c = *this;
+            return c -= n;
+        }
+        std::ptrdiff_t operator- ( const const_iterator& o ) const {
+            return std::ptrdiff_t(i) - std::ptrdiff_t(o.i);
+        }
+
+        bool operator== ( const const_iterator& o ) const { return i == o.i; }
+        bool operator!= ( const const_iterator& o ) const { return i != o.i; }
+        bool operator<  ( const const_iterator& o ) const { return i <  o.i; }
+        bool operator>  ( const const_iterator& o ) const { return i >  o.i; }
+        bool operator<= ( const const_iterator& o ) const { return i <= o.i; }
+        bool operator>= ( const const_iterator& o ) const { return i >= o.i; }
+    };
+
+    using iterator = const_iterator;
+
+    Vector() { }
+
+    Vector( std::initializer_list<X> l ) {
+        for( const X& x : l )
+            push_back( x );
+    }
+
+    /* [b,e) of the same Vector: O(1), sharing its storage. */
+    Vector( const_iterator b, const_iterator e ) {
+        if( b.v and b.v == e.v ) {
+            *this = *b.v;
+            off += b.i;
+            len = e.i - b.i;
+        } else {
+            for( ; b != e; ++b )
+                push_back( *b );
+        }
+    }
+
+    template< class I >
+    Vector( I b, I e ) {
+        for( ; b != e; ++b )
+            push_back( *b );
+    }
+
+    size_t size()  const { return len; }
+    bool   empty() const { return len == 0; }
+
+    const X& operator[] ( size_t i ) const {
+        size_t s = off + i;
+        return leafFor(s)->xs[ s & MASK ];
+    }
+
+    const X& front() const { return (*this)[0]; }
+    const X& back()  const { return (*this)[len-1]; }
+
+    const_iterator begin()  const { return const_iterator( this, 0 ); }
+    const_iterator end()    const { return const_iterator( this, len ); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend()   const { return end(); }
+
+    void push_back( X x ) {
+        // After init or take, the storage past the view belongs to other
+        // Vectors; replace it rather than appending.
+        if( off + len < cnt )
+            set_( off + len, std::move(x) );
+        else
+            conj( std::move(x) );
+        len++;
+    }
+
+    void pop_back() { len--; }
+
+    /* Set the ith element to x, copying only the path to it. */
+    void set( size_t i, X x ) {
+        set_( off + i, std::move(x) );
+    }
+
+    /* O(1) at the end; otherwise, rebuilds everything after b. */
+    const_iterator erase( const_iterator b, const_iterator e ) {
+        size_t i = b.i;
+        Vector rest( e, end() );
+        len = i;
+        for( const X& x : rest )
+            push_back( x );
+        return const_iterator( this, i );
+    }
+
+    const_iterator erase( const_iterator it ) {
+        return erase( it, it + 1 );
+    }
+
+    /* O(1) at the end; otherwise, rebuilds everything after it. */
+    const_iterator insert( const_iterator it, X x ) {
+        size_t i = it.i;
+        Vector rest( it, end() );
+        len = i;
+        push_back( std::move(x) );
+        for( const X& y : rest )
+            push_back( y );
+        return const_iterator( this, i );
+    }
+
+    void clear() { *this = Vector(); }
+};
+
+template< class X >
+bool operator == ( const Vector<X>& a, const Vector<X>& b ) {
+    return a.size() == b.size()
+        and std::equal( a.begin(), a.end(), b.begin() );
+}
+
+template< class X >
+bool operator != ( const Vector<X>& a, const Vector<X>& b ) {
+    return not (a == b);
+}
+
+template< class X >
+bool operator < ( const Vector<X>& a, const Vector<X>& b ) {
+    return std::lexicographical_compare( a.begin(), a.end(),
+                                         b.begin(), b.end() );
+}
+
+} // namespace persistent
+
+} // namespace pure
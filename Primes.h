@@ -0,0 +1,269 @@
+#pragma once
+
+#include "List.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace pure {
+
+namespace list {
+
+/*
+ * Prime numbers by a segmented Sieve of Eratosthenes.
+ *
+ * Trial division tests each candidate against every smaller prime; a sieve
+ * crosses off the multiples of each prime instead, once each. Sieving all of
+ * [0,n) at once takes n bytes, so the range is sieved one segment at a time,
+ * each small enough (32 KiB) to stay in the L1 cache while every prime up to
+ * its square root crosses off its multiples.
+ *
+ * A segment holds only the odd numbers, and starts as a copy of the wheel:
+ * what's left after crossing off the multiples of 3, 5, 7, 11 and 13, a
+ * pattern that repeats every 15015 odd numbers. Only primes from 17 up are
+ * sieved by hand.
+ */
+namespace sieve {
+
+using Prime = unsigned long long;
+
+/* The odd numbers in one segment, one byte each. */
+constexpr size_t SEGMENT = 1 << 15;
+
+/* 3*5*7*11*13: the wheel repeats every WHEEL odd numbers. */
+constexpr size_t WHEEL = 15015;
+
+/* The first prime not on the wheel. */
+constexpr Prime FIRST = 17;
+
+/* wheel()[j] -- is 2j+1 coprime to 3, 5, 7, 11 and 13? */
+inline const std::vector<char>& wheel() {
+    static const std::vector<char> w = [] {
+        std::vector<char> w( WHEEL, 1 );
+        for( size_t p : { 3, 5, 7, 11, 13 } )
+            for( size_t j = p / 2; j < WHEEL; j += p )
+                w[j] = 0;
+        return w;
+    }();
+    return w;
+}
+
+/* floor (sqrt n) */
+inline Prime isqrt( Prime n ) {
+    Prime r = Prime( std::sqrt( (long double) n ) );
+    while( r * r > n )
+        r--;
+    while( r < 0xFFFFFFFFull and (r + 1) * (r + 1) <= n )
+        r++;
+    return r;
+}
+
+/* The primes from FIRST up to n, by a plain sieve. */
+inline std::vector<Prime> basePrimes( Prime n ) {
+    std::vector<char> composite( n / 2 + 1, 0 ); // j stands for 2j+1.
+    std::vector<Prime> ps;
+    for( Prime j = 1; 2 * j + 1 <= n; j++ ) {
+        if( composite[j] )
+            continue;
+        const Prime p = 2 * j + 1;
+        if( p >= FIRST )
+            ps.push_back( p );
+        for( Prime k = p * p / 2; k <= (n - 1) / 2; k += p )
+            composite[k] = 1;
+    }
+    return ps;
+}
+
+/*
+ * Append the primes among the odd numbers lo, lo+2, ... below hi to out,
+ * for an odd lo >= FIRST. base must hold every prime from FIRST up to
+ * sqrt(hi); buf is scratch space.
+ */
+template< class Out >
+void segment( Prime lo, Prime hi, const std::vector<Prime>& base,
+              std::vector<char>& buf, Out& out )
+{
+    const size_t n = size_t( (hi - lo + 1) / 2 );
+    buf.resize( n );
+
+    // Lay down the wheel from lo's place on it.
+    const std::vector<char>& w = wheel();
+    size_t at = size_t( (lo / 2) % WHEEL );
+    for( size_t i = 0; i < n; at = 0 ) {
+        const size_t len = std::min( n - i, WHEEL - at );
+        std::copy( w.begin() + at, w.begin() + at + len, buf.begin() + i );
+        i += len;
+    }
+
+    for( Prime p : base ) {
+        if( p * p >= hi )
+            break;
+        // The first odd multiple of p in the segment, but not p itself.
+        Prime m = std::max( p * p, (lo + p - 1) / p * p );
+        if( m % 2 == 0 )
+            m += p;
+        for( size_t i = size_t( (m - lo) / 2 ); i < n; i += size_t(p) )
+            buf[i] = 0;
+    }
+
+    for( size_t i = 0; i < n; i++ )
+        if( buf[i] )
+            out.push_back( lo + 2 * i );
+}
+
+/* Append the primes in [lo,hi) to out. */
+template< class Out >
+void primesIn( Prime lo, Prime hi, const std::vector<Prime>& base,
+               std::vector<char>& buf, Out& out )
+{
+    for( Prime p : { 2, 3, 5, 7, 11, 13 } )
+        if( lo <= p and p < hi )
+            out.push_back( p );
+
+    for( lo = std::max( lo, FIRST ) | 1; lo < hi; lo += 2 * SEGMENT )
+        segment( lo, std::min( hi, lo + 2 * SEGMENT ), base, buf, out );
+}
+
+} // namespace sieve
+
+/*
+ * Primes -- the infinite sequence [2,3,5,7,11,...].
+ * Like Remember, each prime is found once, when first read, and kept; reading
+ * past the last one sieves the next segment. Iterators refer to the Primes
+ * they came from, so it must outlive them.
+ */
+struct Primes {
+    using Prime = sieve::Prime;
+
+    using container       = Segmented<Prime>;
+    using reference       = container::const_reference;
+    using const_reference = reference;
+    using value_type      = Prime;
+    using difference_type = std::ptrdiff_t;
+
+    mutable container c;
+    mutable Prime sieved = 0;        // c holds every prime below this.
+    mutable std::vector<Prime> base; // The sieving primes,
+    mutable Prime baseLimit = 0;     // up to here.
+    mutable std::vector<char> buf;
+
+    /* Sieve the next segment. */
+    void grow() const {
+        const Prime hi = sieved + 2 * sieve::SEGMENT;
+        const Prime root = sieve::isqrt( hi );
+        if( baseLimit < root ) {
+            // With room to spare, so as not to redo this every segment.
+            baseLimit = 2 * root;
+            base = sieve::basePrimes( baseLimit );
+        }
+        sieve::primesIn( sieved, hi, base, buf, c );
+        sieved = hi;
+    }
+
+    struct iterator
+        : std::iterator< std::bidirectional_iterator_tag, value_type,
+                         difference_type, const Prime*, reference >
+    {
+        const Primes* ps;
+        size_t i;
+
+        iterator( const Primes& ps, size_t i = 0 ) : ps(&ps), i(i) { }
+
+        iterator& operator++ () { i++; return *this; }
+        iterator& operator-- () { i--; return *this; }
+
+        iterator operator++ (int) {
+            iterator copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        iterator operator-- (int) {
+            iterator copy = *this;
+            --(*this);
+            return copy;
+        }
+
+        reference operator* () const {
+            while( i >= ps->c.size() )
+                ps->grow();
+            return ps->c[i];
+        }
+
+        difference_type operator- ( const iterator& o ) const {
+            return difference_type(i) - difference_type(o.i);
+        }
+
+        // Never at the end.
+        constexpr bool operator== ( const iterator& ) const { return false; }
+        constexpr bool operator!= ( const iterator& ) const { return true;  }
+    };
+
+    using const_iterator = iterator;
+
+    iterator begin() const { return iterator( *this ); }
+    iterator end()   const { return iterator( *this, c.size() ); }
+};
+
+inline constexpr size_t _length( const Primes& ) {
+    return std::numeric_limits<size_t>::max();
+}
+
+/* The primes found so far. */
+inline std::vector<sieve::Prime> dup( const Primes& ps ) {
+    return std::vector<sieve::Prime>( begin(ps.c), end(ps.c) );
+}
+
+inline std::vector<sieve::Prime> dup( const Primes& ps, size_t n ) {
+    return dupTo<std::vector>( ps, n );
+}
+
+/* primes = [2,3,5,7,11,...] */
+inline Primes primes() {
+    return Primes();
+}
+
+/*
+ * primesUpTo n -- every prime <= n, in order.
+ * The segments are split into runs, one per task, and sieved across the
+ * parallel::pool(); each run needs only the primes up to sqrt n, which are
+ * found once and shared.
+ */
+inline std::vector<sieve::Prime> primesUpTo( sieve::Prime n ) {
+    using sieve::Prime;
+
+    const Prime hi = n + 1;
+    const Prime span = 2 * sieve::SEGMENT;
+    const std::vector<Prime> base = sieve::basePrimes( sieve::isqrt(hi) );
+
+    const size_t segs = size_t( (hi + span - 1) / span );
+    const size_t k = std::max<size_t>( 1,
+        std::min<size_t>( segs, 4 * parallel::threads() ) );
+
+    std::vector< std::vector<Prime> > pieces( k );
+    parallel::pool().run( k, [&]( size_t c ) {
+        const Prime lo = Prime( c * segs / k ) * span;
+        const Prime top = std::min( hi, Prime( (c+1) * segs / k ) * span );
+        std::vector<char> buf;
+        if( lo < top )
+            sieve::primesIn( lo, top, base, buf, pieces[c] );
+    } );
+
+    size_t total = 0;
+    for( const auto& p : pieces )
+        total += p.size();
+
+    std::vector<Prime> ps;
+    ps.reserve( total );
+    for( const auto& p : pieces )
+        ps.insert( ps.end(), p.begin(), p.end() );
+    return ps;
+}
+
+} // namespace list
+
+} // namespace pure
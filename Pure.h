@@ -26,6 +26,7 @@ using category::Cat;
 
 using data::Just;
 using data::Nothing;
+using data::Inline;
 using data::maybe;
 
 using data::Either;
@@ -370,6 +371,16 @@ std::array<T,N> generate( F&& f ) {
     return cont;
 }
 
+/* n elements into a StaticVec of capacity N: generate<T,N>( f, n ) */
+template< class T, unsigned int N, class F >
+StaticVec<T,N> generate( F&& f, unsigned int n ) {
+    StaticVec<T,N> c;
+    c.reserve(n);
+    while( n-- )
+        c.push_back( forward<F>(f)() );
+    return c;
+}
+
 template< class T, class F >
 std::vector<T> generate( F&& f, unsigned int n ) {
     std::vector<T> c; 
@@ -2,6 +2,8 @@
 #pragma once
 
 #include "List.h"
+#include "Lazy.h"
+#include "FlatSet.h"
 
 #include <algorithm>
 #include <set>
@@ -35,6 +37,11 @@ namespace set {
  * To use this, fully import the namespace with one of the fallowing:
  *      using namespace pure::set; // for generic
  *      using namespace pure::set::ordered;
+ *
+ * On a sorted vector, ordered's s << x is an O(n) insert, and its | keeps
+ * duplicates. A FlatSet (see FlatSet.h) batches insertions and keeps itself
+ * free of duplicates, and ordered's operators on two FlatSets search the
+ * larger when their sizes are far apart.
  */
 
 namespace common {
@@ -58,16 +65,16 @@ unsigned long long operator + ( const S& s ) {
     return pure::list::length( s );
 }
 
-/* The Cartesian product of xs and ys. */
-template< class XS, class YS, 
-          class X = list::SeqVal<XS>, class Y = list::SeqVal<YS>,
-          class P = std::pair<X,Y>,
-          class R = list::Remap<XS,P> >
-R operator * ( const XS& xs, const YS& ys ) {
-    return list::map (
-        []( const X& x, const Y& y ) { return P{x,y}; },
-        xs, ys
-    );
+/*
+ * The Cartesian product of xs and ys, as a lazy view (see lazy::cartesian):
+ * the pairs are made as they're read, not stored. Given it, list::filter,
+ * map and the rest build a std::vector of the pairs.
+ */
+template< class XS, class YS,
+          class = list::SeqVal<XS>, class = list::SeqVal<YS>,
+          class V = list::lazy::ProductView<XS,YS> >
+V operator * ( XS&& xs, YS&& ys ) {
+    return list::lazy::cartesian( std::forward<XS>(xs), std::forward<YS>(ys) );
 }
 
 } // namespace common
@@ -106,18 +113,6 @@ bool operator > ( const S& s, const X& x ) {
     return pure::list::elem( x, s );
 }
 
-/* xs is a subset of ys */
-template< class XS, class YS >
-bool operator <= ( XS xs, const YS& ys ) {
-    for( const auto& y : ys ) {
-        xs <<= y;
-        // If everything in xs has been found in ys, xs is a subset of ys.
-        if( ! xs )
-            return true;
-    }
-    return false;
-}
-
 /* s without x */
 template< class S, class X >
 Decay<S> operator >> ( S&& s, const X& x ) {
@@ -131,6 +126,30 @@ S& operator >>= ( S& s, const X& x ) {
     return s;
 }
 
+// When the elements can be hashed, the operators below put one side in a
+// hash::Table rather than searching it once per element of the other.
+
+/* xs is a subset of ys -- null( xs / ys ) */
+template< class XS, class YS >
+list::XHash<XS,YS,bool> operator <= ( XS xs, const YS& ys ) {
+    for( const auto& y : ys ) {
+        // If everything in xs has been found in ys, xs is a subset of ys.
+        if( ! xs )
+            return true;
+        xs >>= y;
+    }
+    return ! xs;
+}
+
+template< class XS, class YS >
+list::EHash<XS,YS,bool> operator <= ( const XS& xs, const YS& ys ) {
+    auto t = hash::table<list::SeqVal<YS>>( ys );
+    for( const auto& x : xs )
+        if( not t.take(x) )
+            return false;
+    return true;
+}
+
 /* s appended with x */
 template< class S, class X >
 Decay<S> operator << ( S&& s, X&& x ) {
@@ -146,13 +165,28 @@ S& operator <<= ( S& s, X&& x ) {
 
 /* The union of xs and ys (with no duplicates). */
 template< class XS, class YS >
-XS operator | ( XS xs, YS&& ys ) {
+list::XHash<XS,YS,XS> operator | ( XS xs, YS&& ys ) {
     for( auto y : std::forward<YS>(ys) ) 
         if( not (y<xs) )
             xs <<= y;
     return xs;
 }
 
+template< class XS, class YS >
+list::EHash<XS,YS,XS> operator | ( XS xs, const YS& ys ) {
+    using X = list::SeqVal<XS>;
+    std::vector<const X*> ns; // The ys not in xs, in order.
+    {
+        auto t = hash::table<X>( xs );
+        for( const X& y : ys )
+            if( t.insert(y) )
+                ns.push_back( &y );
+    }
+    for( const X* y : ns )
+        xs <<= *y;
+    return xs;
+}
+
 /* (reference version) */
 template< class XS, class YS >
 XS& operator |= ( XS& xs, YS&& ys ) {
@@ -162,12 +196,23 @@ XS& operator |= ( XS& xs, YS&& ys ) {
 
 /* Every x from xs such that there is no y from ys where x = y. */
 template< class XS, class YS >
-XS operator / ( XS xs, const YS& ys ) {
+list::XHash<XS,YS,XS> operator / ( XS xs, const YS& ys ) {
     for( const auto& y : ys )
         xs >>= y;
     return xs;
 }
 
+template< class XS, class YS >
+list::EHash<XS,YS,XS> operator / ( const XS& xs, const YS& ys ) {
+    // Each y removes one x, the first.
+    auto t = hash::table<list::SeqVal<YS>>( ys );
+    XS r;
+    for( const auto& x : xs )
+        if( not t.take(x) )
+            r <<= x;
+    return r;
+}
+
 /* (reference version) */
 template< class XS, class YS >
 XS& operator /= ( XS& xs, const YS& ys ) {
@@ -177,7 +222,7 @@ XS& operator /= ( XS& xs, const YS& ys ) {
 
 /* The intersection of xs and ys. (Or: The remainder of xs/ys.) */
 template< class XS, class YS >
-XS operator % ( const XS& xs, const YS& ys ) {
+list::XHash<XS,YS,XS> operator % ( const XS& xs, const YS& ys ) {
     XS r;
     for( const auto& y : ys )
         if( y < xs )
@@ -185,6 +230,16 @@ XS operator % ( const XS& xs, const YS& ys ) {
     return r;
 }
 
+template< class XS, class YS >
+list::EHash<XS,YS,XS> operator % ( const XS& xs, const YS& ys ) {
+    auto t = hash::table<list::SeqVal<XS>>( xs );
+    XS r;
+    for( const auto& y : ys )
+        if( t.count(y) )
+            r <<= y;
+    return r;
+}
+
 /* (reference version) */
 template< class XS, class YS >
 XS& operator %= ( XS& xs, YS&& ys ) {
@@ -292,6 +347,76 @@ XS& operator %= ( XS& xs, YS&& ys ) {
     return xs;
 }   
 
+// On FlatSets, these use the algorithms in FlatSet.h.
+
+template< class X, class T, class C >
+bool operator < ( const X& x, const FlatSet<T,C>& s ) {
+    return s.contains( x );
+}
+
+template< class T, class C, class X >
+bool operator > ( const FlatSet<T,C>& s, const X& x ) {
+    return s.contains( x );
+}
+
+template< class X, class C >
+bool operator <= ( const FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    return flat::subset( xs, ys );
+}
+
+template< class X, class C, class Y >
+FlatSet<X,C> operator >> ( FlatSet<X,C> s, const Y& y ) {
+    s.erase( X(y) );
+    return s;
+}
+
+/* Adding x is O(1); the next read sorts in everything added since. */
+template< class X, class C, class Y >
+flat::EElement<Y,X,FlatSet<X,C>&> operator <<= ( FlatSet<X,C>& s, Y&& y ) {
+    s.insert( std::forward<Y>(y) );
+    return s;
+}
+
+/* s <<= ys -- adds every y, sorting them in once. */
+template< class X, class C, class YS >
+flat::XElement<YS,X,FlatSet<X,C>&> operator <<= ( FlatSet<X,C>& s,
+                                                  YS&& ys )
+{
+    s.insert( begin(ys), end(ys) );
+    return s;
+}
+
+template< class X, class C, class Y >
+FlatSet<X,C> operator << ( FlatSet<X,C> s, Y&& y ) {
+    s <<= std::forward<Y>(y);
+    return s;
+}
+
+/* The union, merged into xs's storage. */
+template< class X, class C >
+FlatSet<X,C> operator | ( FlatSet<X,C> xs, const FlatSet<X,C>& ys ) {
+    flat::unite( xs, ys );
+    return xs;
+}
+
+template< class X, class C, class YS >
+typename std::enable_if <
+    std::is_same< Decay<YS>, FlatSet<X,C> >::value, FlatSet<X,C>&
+>::type operator |= ( FlatSet<X,C>& xs, YS&& ys ) {
+    flat::unite( xs, ys );
+    return xs;
+}
+
+template< class X, class C >
+FlatSet<X,C> operator / ( const FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    return flat::difference( xs, ys );
+}
+
+template< class X, class C >
+FlatSet<X,C> operator % ( const FlatSet<X,C>& xs, const FlatSet<X,C>& ys ) {
+    return flat::intersect( xs, ys );
+}
+
 } // namespace ordered
 
 using namespace generic;
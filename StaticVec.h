@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace pure {
+
+/*
+ * StaticVec X N -- a vector of at most N elements, stored inline.
+ *
+ * Like std::array, it never touches the heap; like std::vector, it has a
+ * size, push_back and erase. List.h treats it as it does a vector: map and
+ * filter give back a StaticVec of the same capacity, cons_ and append_ push
+ * onto one, so a pipeline over a few elements in a hot loop costs no
+ * mallocs at all. Growing one past N throws std::length_error.
+ */
+template< class X, size_t N >
+class StaticVec {
+    using Storage = typename std::aligned_storage <
+        sizeof(X), alignof(X)
+    >::type;
+
+    Storage buf[ N ? N : 1 ];
+    size_t n = 0;
+
+    X* at_( size_t i ) { return reinterpret_cast<X*>( buf + i ); }
+    const X* at_( size_t i ) const {
+        return reinterpret_cast<const X*>( buf + i );
+    }
+
+    void room( size_t m ) const {
+        if( m > N )
+            throw std::length_error( "StaticVec: over capacity" );
+    }
+
+    // Trivial elements are copied, or moved, as bytes.
+    using Trivial = std::is_trivially_copyable<X>;
+
+    void copyFrom( const StaticVec& o, std::true_type ) {
+        std::memcpy( buf, o.buf, o.n * sizeof(X) );
+        n = o.n;
+    }
+
+    void copyFrom( const StaticVec& o, std::false_type ) {
+        for( const X& x : o )
+            push_back( x );
+    }
+
+    void moveFrom( StaticVec& o, std::true_type ) { copyFrom( o, Trivial() ); }
+
+    void moveFrom( StaticVec& o, std::false_type ) {
+        for( X& x : o )
+            push_back( std::move(x) );
+    }
+
+  public:
+    using value_type      = X;
+    using reference       = X&;
+    using const_reference = const X&;
+    using pointer         = X*;
+    using const_pointer   = const X*;
+    using iterator        = X*;
+    using const_iterator  = const X*;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    StaticVec() { }
+
+    explicit StaticVec( size_t m ) { resize( m ); }
+    StaticVec( size_t m, const X& x ) { resize( m, x ); }
+
+    StaticVec( std::initializer_list<X> l ) : StaticVec( l.begin(), l.end() ) {
+    }
+
+    template< class I, class = typename std::iterator_traits<I>::reference >
+    StaticVec( I b, I e ) {
+        for( ; b != e; ++b )
+            push_back( *b );
+    }
+
+    StaticVec( const StaticVec& o ) { copyFrom( o, Trivial() ); }
+    StaticVec( StaticVec&& o )      { moveFrom( o, Trivial() ); }
+
+    ~StaticVec() { clear(); }
+
+    StaticVec& operator = ( const StaticVec& o ) {
+        if( this != &o ) {
+            clear();
+            copyFrom( o, Trivial() );
+        }
+        return *this;
+    }
+
+    StaticVec& operator = ( StaticVec&& o ) {
+        if( this != &o ) {
+            clear();
+            moveFrom( o, Trivial() );
+        }
+        return *this;
+    }
+
+    template< class I >
+    void assign( I b, I e ) {
+        clear();
+        for( ; b != e; ++b )
+            push_back( *b );
+    }
+
+    iterator       begin()        { return at_(0); }
+    const_iterator begin()  const { return at_(0); }
+    iterator       end()          { return at_(n); }
+    const_iterator end()    const { return at_(n); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend()   const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator( end() ); }
+    reverse_iterator rend()   { return reverse_iterator( begin() ); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator( end() );
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator( begin() );
+    }
+
+    X*       data()       { return at_(0); }
+    const X* data() const { return at_(0); }
+
+    size_t size() const { return n; }
+    bool  empty() const { return n == 0; }
+    bool   full() const { return n == N; }
+
+    static constexpr size_t capacity() { return N; }
+    static constexpr size_t max_size() { return N; }
+
+    /* There is nothing to allocate; only check that m fits. */
+    void reserve( size_t m ) const { room( m ); }
+
+    X&       operator [] ( size_t i )       { return *at_(i); }
+    const X& operator [] ( size_t i ) const { return *at_(i); }
+
+    X& at( size_t i ) {
+        if( i >= n )
+            throw std::out_of_range( "StaticVec::at" );
+        return *at_(i);
+    }
+    const X& at( size_t i ) const {
+        if( i >= n )
+            throw std::out_of_range( "StaticVec::at" );
+        return *at_(i);
+    }
+
+    X&       front()       { return *at_(0); }
+    const X& front() const { return *at_(0); }
+    X&       back()        { return *at_(n-1); }
+    const X& back()  const { return *at_(n-1); }
+
+    template< class ...Y >
+    X& emplace_back( Y&& ...y ) {
+        room( n + 1 );
+        new (at_(n)) X( std::forward<Y>(y)... );
+        return *at_(n++);
+    }
+
+    void push_back( const X& x ) { emplace_back( x ); }
+    void push_back( X&& x )      { emplace_back( std::move(x) ); }
+
+    void pop_back() { at_(--n)->~X(); }
+
+    iterator insert( const_iterator pos, X x ) {
+        const size_t i = size_t( pos - begin() );
+        emplace_back( std::move(x) );
+        std::rotate( begin() + i, end() - 1, end() );
+        return begin() + i;
+    }
+
+    template< class I, class = typename std::iterator_traits<I>::reference >
+    iterator insert( const_iterator pos, I b, I e ) {
+        const size_t i = size_t( pos - begin() ), m = n;
+        for( ; b != e; ++b )
+            push_back( *b );
+        std::rotate( begin() + i, begin() + m, end() );
+        return begin() + i;
+    }
+
+    iterator erase( const_iterator b, const_iterator e ) {
+        iterator first = begin() + (b - begin());
+        iterator rest = std::move( first + (e - b), end(), first );
+        while( end() != rest )
+            pop_back();
+        return first;
+    }
+
+    iterator erase( const_iterator it ) { return erase( it, it + 1 ); }
+
+    void clear() {
+        while( n )
+            pop_back();
+    }
+
+    void resize( size_t m ) {
+        room( m );
+        while( n > m )
+            pop_back();
+        while( n < m )
+            emplace_back();
+    }
+
+    void resize( size_t m, const X& x ) {
+        room( m );
+        while( n > m )
+            pop_back();
+        while( n < m )
+            emplace_back( x );
+    }
+
+    void swap( StaticVec& o ) {
+        StaticVec t( std::move(o) );
+        o = std::move( *this );
+        *this = std::move( t );
+    }
+};
+
+template< class X, size_t N >
+bool operator == ( const StaticVec<X,N>& a, const StaticVec<X,N>& b ) {
+    return a.size() == b.size() and std::equal( a.begin(), a.end(), b.begin() );
+}
+
+template< class X, size_t N >
+bool operator != ( const StaticVec<X,N>& a, const StaticVec<X,N>& b ) {
+    return not (a == b);
+}
+
+template< class X, size_t N >
+bool operator < ( const StaticVec<X,N>& a, const StaticVec<X,N>& b ) {
+    return std::lexicographical_compare( a.begin(), a.end(),
+                                         b.begin(), b.end() );
+}
+
+template< class X, size_t N >
+void swap( StaticVec<X,N>& a, StaticVec<X,N>& b ) {
+    a.swap( b );
+}
+
+} // namespace pure
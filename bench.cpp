@@ -0,0 +1,641 @@
+
+/*
+ * Benchmarks: List.h's combinators against the STL loops they replace.
+ *
+ *      make bench > bench.json
+ *
+ * Each case is timed twice per container and size: once through Pure, once
+ * as the loop one would write by hand with <algorithm>. Both versions build
+ * the same result, and the run notes whether they agree. For each, it
+ * reports the best nanoseconds per element over a few trials, and the
+ * allocations per element of one call, counted by replacing operator new.
+ *
+ * The results go to stdout as JSON; a readable table goes to stderr.
+ */
+
+#include "Pure.h"
+#include "Lazy.h"
+#include "Set.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace list = pure::list;
+
+/* ALLOCATION COUNTING */
+
+static size_t allocations = 0;
+
+// Not inlined: GCC would see each delete call free memory from new, and
+// warn that they don't match.
+#if defined(__GNUC__)
+#   define BENCH_NOINLINE __attribute__((noinline))
+#else
+#   define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* operator new ( size_t n ) {
+    allocations++;
+    if( void* p = std::malloc( n ? n : 1 ) )
+        return p;
+    throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void operator delete ( void* p ) noexcept { std::free( p ); }
+
+BENCH_NOINLINE void operator delete ( void* p, size_t ) noexcept {
+    std::free( p );
+}
+
+/* TIMING */
+
+// Keep the compiler from discarding a result it can see is never read.
+template< class X > void keep( const X& x ) {
+#if defined(__GNUC__)
+    asm volatile( "" : : "g"(&x) : "memory" );
+#else
+    static volatile const void* sink;
+    sink = &x;
+#endif
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct Measure {
+    double nsPerElem;
+    double allocsPerElem;
+};
+
+/* The best of a few trials, each run long enough to time. */
+template< class F >
+Measure measure( const F& f, size_t n ) {
+    const auto minTrial = std::chrono::milliseconds( 5 );
+
+    size_t before = allocations;
+    keep( f() );
+    double allocs = double( allocations - before );
+
+    size_t reps = 1;
+    double best = 1e300;
+    for( int trial = 0; trial < 3; ) {
+        auto t0 = Clock::now();
+        for( size_t i = 0; i < reps; i++ )
+            keep( f() );
+        auto dt = Clock::now() - t0;
+
+        if( dt < minTrial and reps < (size_t(1) << 30) ) {
+            reps *= 2;
+            continue;
+        }
+        double ns = std::chrono::duration<double,std::nano>( dt ).count();
+        best = std::min( best, ns / reps );
+        trial++;
+    }
+
+    size_t m = n ? n : 1;
+    return Measure{ best / m, allocs / m };
+}
+
+/* What two results must share to agree: the same elements, in order. */
+template< class X >
+std::vector<long long> flat( const X& x, ... ) {
+    return { (long long) x };
+}
+
+template< class S >
+auto flat( const S& s, int )
+    -> decltype( std::begin(s), std::vector<long long>() )
+{
+    std::vector<long long> r;
+    for( const auto& x : s ) {
+        auto f = flat( x, 0 );
+        r.insert( r.end(), f.begin(), f.end() );
+        r.push_back( -1 );
+    }
+    return r;
+}
+
+/* REPORTING */
+
+static bool firstRow = true;
+
+void report( const char* combinator, const char* container, size_t n,
+             const Measure& p, const Measure& s, bool agree )
+{
+    std::printf( "%s\n    {\"combinator\": \"%s\", \"container\": \"%s\", "
+                 "\"n\": %zu,\n"
+                 "     \"pure\": {\"ns_per_elem\": %.3f, "
+                 "\"allocs_per_elem\": %.4f},\n"
+                 "     \"stl\": {\"ns_per_elem\": %.3f, "
+                 "\"allocs_per_elem\": %.4f},\n"
+                 "     \"ratio\": %.3f, \"agree\": %s}",
+                 firstRow ? "" : ",", combinator, container, n,
+                 p.nsPerElem, p.allocsPerElem, s.nsPerElem, s.allocsPerElem,
+                 p.nsPerElem / s.nsPerElem, agree ? "true" : "false" );
+    firstRow = false;
+
+    std::fprintf( stderr, "%-11s %-13s %7zu  pure %9.2f ns %7.3f al"
+                          "   stl %9.2f ns %7.3f al   x%6.2f%s\n",
+                  combinator, container, n,
+                  p.nsPerElem, p.allocsPerElem, s.nsPerElem, s.allocsPerElem,
+                  p.nsPerElem / s.nsPerElem, agree ? "" : "  DISAGREE" );
+}
+
+template< class Case, class S >
+void run( const char* container, const S& s, size_t n ) {
+    auto p = [&] { return Case::pure( s ); };
+    auto b = [&] { return Case::stl( s ); };
+    bool agree = flat( p(), 0 ) == flat( b(), 0 );
+    report( Case::name(), container, n, measure(p,n), measure(b,n), agree );
+}
+
+/* CASES */
+
+struct Inc {
+    template< class X > X operator () ( X x ) const { return x + 1; }
+};
+
+struct Even {
+    template< class X > bool operator () ( X x ) const { return x % 2 == 0; }
+};
+
+struct IsZero {
+    template< class X > bool operator () ( X x ) const { return x % 8 == 0; }
+};
+
+struct Twice {
+    template< class X > std::vector<X> operator () ( X x ) const {
+        return { x, x };
+    }
+};
+
+template< class S > using Val = list::SeqVal<S>;
+
+struct Map {
+    static const char* name() { return "map"; }
+
+    template< class S > static S pure( const S& s ) {
+        return list::map( Inc(), s );
+    }
+
+    template< class S > static S stl( const S& s ) {
+        S r = s;
+        std::transform( s.begin(), s.end(), r.begin(), Inc() );
+        return r;
+    }
+};
+
+struct Filter {
+    static const char* name() { return "filter"; }
+
+    template< class S > static S pure( const S& s ) {
+        return list::filter( Even(), s );
+    }
+
+    template< class S > static S stl( const S& s ) {
+        S r;
+        std::copy_if( s.begin(), s.end(), std::back_inserter(r), Even() );
+        return r;
+    }
+};
+
+struct Foldl {
+    static const char* name() { return "foldl"; }
+
+    template< class S > static long pure( const S& s ) {
+        return list::foldl( std::plus<long>(), 0l, s );
+    }
+
+    template< class S > static long stl( const S& s ) {
+        return std::accumulate( s.begin(), s.end(), 0l );
+    }
+};
+
+struct Foldr {
+    static const char* name() { return "foldr"; }
+
+    struct Step {
+        long operator () ( long x, long acc ) const { return acc * 3 + x; }
+    };
+
+    template< class S > static long pure( const S& s ) {
+        return list::foldr( Step(), 0l, s );
+    }
+
+    template< class S > static long stl( const S& s ) {
+        long acc = 0;
+        for( auto it = s.rbegin(); it != s.rend(); ++it )
+            acc = Step()( *it, acc );
+        return acc;
+    }
+};
+
+struct ZipWith {
+    static const char* name() { return "zipWith"; }
+
+    template< class S > static S pure( const S& s ) {
+        return list::zipWith( std::plus<Val<S>>(), s, s );
+    }
+
+    template< class S > static S stl( const S& s ) {
+        S r = s;
+        std::transform( s.begin(), s.end(), s.begin(), r.begin(),
+                        std::plus<Val<S>>() );
+        return r;
+    }
+};
+
+struct ConcatMap {
+    static const char* name() { return "concatMap"; }
+
+    template< class S > static std::vector<Val<S>> pure( const S& s ) {
+        return list::concatMap( Twice(), s );
+    }
+
+    template< class S > static std::vector<Val<S>> stl( const S& s ) {
+        std::vector<Val<S>> r;
+        r.reserve( 2 * s.size() );
+        for( const auto& x : s ) {
+            r.push_back( x );
+            r.push_back( x );
+        }
+        return r;
+    }
+};
+
+struct Scanl {
+    static const char* name() { return "scanl"; }
+
+    template< class S > static std::vector<long> pure( const S& s ) {
+        return list::scanl( std::plus<long>(), 0l, s );
+    }
+
+    template< class S > static std::vector<long> stl( const S& s ) {
+        std::vector<long> r;
+        r.reserve( s.size() + 1 );
+        long acc = 0;
+        r.push_back( acc );
+        for( const auto& x : s )
+            r.push_back( acc += x );
+        return r;
+    }
+};
+
+struct SplitBy {
+    static const char* name() { return "splitBy"; }
+
+    template< class S > static std::vector<S> pure( const S& s ) {
+        return list::splitBy( IsZero(), s );
+    }
+
+    // Like splitBy: the first piece may be empty; runs of delimiters count
+    // as one.
+    template< class S > static std::vector<S> stl( const S& s ) {
+        std::vector<S> r;
+        auto b = s.begin(), e = s.end();
+        auto m = std::find_if( b, e, IsZero() );
+        while( true ) {
+            r.emplace_back( b, m );
+            b = std::find_if_not( m, e, IsZero() );
+            if( b == e )
+                return r;
+            m = std::find_if( b, e, IsZero() );
+        }
+    }
+};
+
+struct Group {
+    static const char* name() { return "group"; }
+
+    template< class S > static std::vector<S> pure( const S& s ) {
+        return list::group( s );
+    }
+
+    template< class S > static std::vector<S> stl( const S& s ) {
+        std::vector<S> r;
+        for( auto b = s.begin(); b != s.end(); ) {
+            auto e = std::find_if( b, s.end(), [&]( const Val<S>& x ) {
+                return not (x == *b);
+            } );
+            r.emplace_back( b, e );
+            b = e;
+        }
+        return r;
+    }
+};
+
+struct Fork {
+    static const char* name() { return "fork"; }
+
+    template< int K > struct ModIs {
+        template< class X > bool operator () ( X x ) const {
+            return x % 5 == K;
+        }
+    };
+
+    // The leftovers first, then what each predicate took.
+    template< class S > static std::vector<S> pure( const S& s ) {
+        std::vector<S> r( 5 );
+        std::tie( r[0], r[1], r[2], r[3], r[4] ) = pure::tpl::fork (
+            s, ModIs<0>(), ModIs<1>(), ModIs<2>(), ModIs<3>()
+        );
+        return r;
+    }
+
+    template< class S > static std::vector<S> stl( const S& s ) {
+        std::vector<S> r( 5 );
+        for( const auto& x : s ) {
+            const int k = x % 5;
+            r[ k < 4 ? k + 1 : 0 ].push_back( x );
+        }
+        return r;
+    }
+};
+
+struct Sort {
+    static const char* name() { return "sort"; }
+
+    template< class S > static S pure( const S& s ) {
+        return list::sort( s );
+    }
+
+    template< class X >
+    static void sortIn( std::list<X>& l ) { l.sort(); }
+
+    template< class S >
+    static void sortIn( S& s ) { std::sort( s.begin(), s.end() ); }
+
+    template< class S > static S stl( const S& s ) {
+        S r = s;
+        sortIn( r );
+        return r;
+    }
+};
+
+struct Nub {
+    static const char* name() { return "nub"; }
+
+    template< class S > static S pure( const S& s ) {
+        return list::nub( s );
+    }
+
+    // nub gives the unique elements, sorted.
+    template< class S > static S stl( const S& s ) {
+        S r = s;
+        std::sort( r.begin(), r.end() );
+        r.erase( std::unique(r.begin(), r.end()), r.end() );
+        return r;
+    }
+};
+
+/*
+ * The set operations take a pair of sorted sets, as std::set_union and
+ * friends need: a set and the same set shifted up by three.
+ */
+template< class S > using Sets = std::pair<S,S>;
+
+struct Union {
+    static const char* name() { return "sunion"; }
+
+    template< class S > static S pure( const Sets<S>& s ) {
+        return list::sunion( s.first, s.second );
+    }
+
+    template< class S > static S stl( const Sets<S>& s ) {
+        S r;
+        std::set_union( s.first.begin(), s.first.end(),
+                        s.second.begin(), s.second.end(),
+                        std::back_inserter(r) );
+        return r;
+    }
+};
+
+struct Intersect {
+    static const char* name() { return "intersect"; }
+
+    template< class S > static S pure( const Sets<S>& s ) {
+        return list::intersect( s.first, s.second );
+    }
+
+    template< class S > static S stl( const Sets<S>& s ) {
+        S r;
+        std::set_intersection( s.first.begin(), s.first.end(),
+                               s.second.begin(), s.second.end(),
+                               std::back_inserter(r) );
+        return r;
+    }
+};
+
+struct Difference {
+    static const char* name() { return "difference"; }
+
+    template< class S > static S pure( const Sets<S>& s ) {
+        return list::difference( s.first, s.second );
+    }
+
+    template< class S > static S stl( const Sets<S>& s ) {
+        S r;
+        std::set_difference( s.first.begin(), s.first.end(),
+                             s.second.begin(), s.second.end(),
+                             std::back_inserter(r) );
+        return r;
+    }
+};
+
+/* set::ordered's % on a pair of FlatSets. */
+struct FlatIntersect {
+    static const char* name() { return "flat %"; }
+
+    template< class S > static S pure( const Sets<S>& s ) {
+        using namespace pure::set::ordered;
+        return s.first % s.second;
+    }
+
+    template< class S > static std::vector<int> stl( const Sets<S>& s ) {
+        std::vector<int> r;
+        std::set_intersection( s.first.begin(), s.first.end(),
+                               s.second.begin(), s.second.end(),
+                               std::back_inserter(r) );
+        return r;
+    }
+};
+
+/* The generators take n, not a sequence. */
+struct Iterate {
+    static const char* name() { return "iterate"; }
+
+    static std::vector<int> pure( size_t n ) {
+        return list::dupTo<std::vector>( list::lazy::take(
+            n, list::iterate( Inc(), 0 )
+        ) );
+    }
+
+    static std::vector<int> stl( size_t n ) {
+        std::vector<int> r;
+        int x = 0;
+        for( size_t i = 0; i < n; i++, x = Inc()(x) )
+            r.push_back( x );
+        return r;
+    }
+};
+
+struct Memorize {
+    static const char* name() { return "memorize"; }
+
+    struct Next {
+        template< class S > int operator () ( const S& s ) const {
+            return s.back() + s[ s.size() / 2 ];
+        }
+    };
+
+    static std::vector<int> pure( size_t n ) {
+        return list::dupTo<std::vector>(
+            list::lazy::take( n, list::memorize( Next(), 1 ) )
+        );
+    }
+
+    static std::vector<int> stl( size_t n ) {
+        std::vector<int> r{ 1 };
+        while( r.size() < n )
+            r.push_back( Next()( r ) );
+        r.resize( n );
+        return r;
+    }
+};
+
+/* DATA */
+
+/* n ints, with runs (for group) and repeats (for nub and the set ops). */
+template< class S > S numbers( size_t n ) {
+    S s;
+    for( size_t i = 0; i < n; i++ )
+        s.push_back( int( (i / 3 * 2654435761u >> 7) % (n / 2 + 1) ) );
+    return s;
+}
+
+std::string text( size_t n ) {
+    const std::string words = "the quick  brown fox jumps over the lazy dog\n";
+    std::string s;
+    for( size_t i = 0; i < n; i++ )
+        s.push_back( words[ i % words.size() ] );
+    return s;
+}
+
+/* Runs every case that makes sense for each kind of sequence. */
+template< class S >
+void growable( const char* container, const S& s ) {
+    size_t n = s.size();
+    run<Map>( container, s, n );
+    run<Filter>( container, s, n );
+    run<Foldl>( container, s, n );
+    run<Foldr>( container, s, n );
+    run<ZipWith>( container, s, n );
+    run<ConcatMap>( container, s, n );
+    run<Scanl>( container, s, n );
+    run<SplitBy>( container, s, n );
+    run<Group>( container, s, n );
+    run<Fork>( container, s, n );
+}
+
+template< class S >
+void setOps( const char* container, const S& s ) {
+    Sets<S> sets( s, S() );
+    for( const auto& x : s )
+        sets.second.push_back( x + 3 );
+
+    size_t n = s.size();
+    run<Union>( container, sets, n );
+    run<Intersect>( container, sets, n );
+    run<Difference>( container, sets, n );
+}
+
+/*
+ * FlatSet intersections: of a set and the same set shifted up by three, and
+ * of a set and every hundredth element of it, skewed as posting lists are.
+ */
+void flatSets( const std::vector<int>& set ) {
+    using FS = pure::FlatSet<int>;
+    Sets<FS> shifted( FS( set.begin(), set.end() ), FS() );
+    Sets<FS> skewed( shifted.first, FS() );
+    for( size_t i = 0; i < set.size(); i++ ) {
+        shifted.second.insert( set[i] + 3 );
+        if( i % 100 == 0 )
+            skewed.second.insert( set[i] );
+    }
+
+    size_t n = set.size();
+    run<FlatIntersect>( "FlatSet<int>", shifted, n );
+    run<FlatIntersect>( "FlatSet 100:1", skewed, n );
+}
+
+// A std::array can't grow, so only the cases that keep its size.
+template< class S >
+void fixed( const char* container, const S& s ) {
+    size_t n = s.size();
+    run<Map>( container, s, n );
+    run<Foldl>( container, s, n );
+    run<Foldr>( container, s, n );
+    run<ZipWith>( container, s, n );
+    run<Scanl>( container, s, n );
+    run<Sort>( container, s, n );
+}
+
+template< size_t N >
+void arrays() {
+    std::unique_ptr<std::array<int,N>> a( new std::array<int,N> );
+    auto v = numbers<std::vector<int>>( N );
+    std::copy( v.begin(), v.end(), a->begin() );
+    fixed( "array<int>", *a );
+}
+
+template< class Case >
+void generator( size_t n ) {
+    auto p = [&] { return Case::pure( n ); };
+    auto b = [&] { return Case::stl( n ); };
+    bool agree = flat( p(), 0 ) == flat( b(), 0 );
+    report( Case::name(), "-", n, measure(p,n), measure(b,n), agree );
+}
+
+int main() {
+    const size_t sizes[] = { 16, 1024, 65536 };
+
+    std::printf( "{\"results\": [" );
+    for( size_t n : sizes ) {
+        auto v = numbers<std::vector<int>>( n );
+        auto t = text( n );
+        growable( "vector<int>", v );
+        growable( "list<int>", numbers<std::list<int>>(n) );
+        growable( "string", t );
+        if( n <= 16 )
+            growable( "StaticVec", numbers< pure::StaticVec<int,16> >(n) );
+
+        // list::sort and nub need random access.
+        run<Sort>( "vector<int>", v, n );
+        run<Sort>( "string", t, n );
+        run<Nub>( "vector<int>", v, n );
+        run<Nub>( "string", t, n );
+
+        auto set = Nub::stl( v );
+        setOps( "vector<int>", set );
+        setOps( "list<int>", std::list<int>( set.begin(), set.end() ) );
+        flatSets( set );
+
+        generator<Iterate>( n );
+        generator<Memorize>( n );
+    }
+    arrays<16>();
+    arrays<1024>();
+    arrays<65536>();
+    std::printf( "\n]}\n" );
+}
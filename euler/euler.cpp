@@ -2,6 +2,8 @@
 #include "../Pure.h"
 #include "../Arrow.h"
 #include "../Applicative.h"
+#include "../Primes.h"
+#include "../BigInt.h"
 
 using namespace pure;
 using namespace list;
@@ -69,18 +71,19 @@ struct ToInt {
     }
 } toInt;
 
-vector<int> multiples_less_than_1000( int x ) {
-    return take (
-        999 / x, // x goes into 1000 (999/x) times.
-        iterate( add(x), x )
-    );
+IRange multiples_less_than_1000( unsigned int x ) {
+    return enumerate( x, 999, x );
 }
 
 void problem1() {
+    auto threes = multiples_less_than_1000(3);
+    auto fives  = multiples_less_than_1000(5);
+
+    // The union, without counting the multiples of 15 twice. Each is a
+    // progression, so nothing here walks the ranges.
     cout << "The sum of every multiple of 3 or 5 between 1 and 1000: "
          << flush <<
-         sum( sunion( multiples_less_than_1000(3),
-                      multiples_less_than_1000(5) ) )
+         sum(threes) + sum(fives) - sum( intersect(threes, fives) )
          << endl;
 }
 
@@ -106,14 +109,8 @@ void problem2() {
 
 using PrimeType = unsigned long long int;
 
-PrimeType next_prime( const vector<PrimeType>& past ) {
-    PrimeType x = last( past );
-    do x += 2;
-    while( any( divisorOf(x), reverse_wrap(tail_wrap(2,past)) ) );
-    return x;
-}
-
-auto primes = memorize( next_prime, 1ull, 2ull, 3ull, 5ull, 7ull, 11ull );
+// Sieved a segment at a time, as far as anything reads.
+auto primeSeq = list::primes();
 
 void problem3() {
     const long int START = 600851475143;
@@ -121,7 +118,7 @@ void problem3() {
 
     cout << "The largest prime divisor of " << START << flush;
 
-    auto p = next(begin( primes ));
+    auto p = begin( primeSeq );
 
     while( *p < std::sqrt(x) )
         if( x % *p++ == 0 )
@@ -148,52 +145,6 @@ struct DigitsT {
     }
 } digits;
 
-Digits operator* ( Digits ds, int x ) {
-    unsigned int carry = 0;
-    ds = map (
-        [&]( unsigned int d ) {
-            auto r = d * x + carry;
-            carry = r / 10;
-            return r % 10;
-        },
-        reverse(move(ds))
-    );
-
-    return reverse( append( move(ds), digits(carry) ) );
-}
-
-Digits operator* ( int x, Digits ds ) {
-    return move(ds) * x;
-}
-
-Digits operator+ ( Digits ds, unsigned long long x ) {
-    for( size_t i = 0; i < length(ds) and x>0; i++ ) {
-        auto& d = last( ds, i );
-        auto r = d + x;
-        d = r % 10;
-        x = r / 10;
-    }
-
-    return x ? append( reverse(digits(x)), ds )
-        : ds;
-}
-
-Digits operator+ ( Digits a, const Digits& b ) {
-    if( length(b) > length(a) )
-        return move(b) + move(a);
-
-    unsigned long carry = 0;
-    for( size_t i = 0; i < length(a); i++ ) {
-        auto& ai = last( a, i );
-        auto& bi = last( b, i );
-        auto r = ai + bi + carry;
-        ai = r % 10;
-        carry = r / 10;
-    }
-
-    return carry ? append( reverse(digits(carry)), a ) : a;
-}
-
 bool _palindrome( const vector<unsigned int>& v ) {
     return equal( v, reverse_wrap(v) );
 }
@@ -292,7 +243,7 @@ void problem6() {
 
 void problem7() {
     cout << "The 1001'st prime number: " << flush;
-    cout << *next( begin(primes), 10001 ) << endl;
+    cout << *next( begin(primeSeq), 10000 ) << endl;
 }
 
 int from_sym( char sym ) { return sym - '0'; }
@@ -331,26 +282,9 @@ void problem9() {
          << int(a*b*c()) << " when multiplied. " << endl;
 }
 
-bool _notDivisibleByOdd( PrimeType odd, PrimeType x ) {
-    for( ; odd <= std::sqrt(x); odd += 2 )
-        if( x % odd == 0 )
-            return false;
-    return true;
-}
-
-bool notDivisibleByOdd( PrimeType x ) {
-    return _notDivisibleByOdd( 3, x );
-}
-
 void problem10() {
     cout << "The sum of all primes below 2 million is: " << flush;
-    PrimeType ds = 2;
-    for( PrimeType x=3; x < 2000000; x+=2 ) {
-        // Using the memorized "primes" is too slow for large primes. 
-        if( notDivisibleByOdd(x) )
-            ds = ds + x;
-    }
-    cout << ds << endl;
+    cout << sum( primesUpTo(2000000 - 1) ) << endl;
 }
 
 using Row = vector<unsigned int>;
@@ -433,7 +367,7 @@ using Factors = std::vector<PrimeType>;
 #include "../Set.h"
 bool isPrime( Factor x ) {
     using namespace pure::list::taking;
-    return elem( x, primes < x );
+    return elem( x, primeSeq < x );
 }
 
 // Computes the low factors of x, given an accumulation of low factors. 
@@ -455,7 +389,8 @@ Factors _lowFactors( Factors lfs, Factor x ) {
 Factors primeFactors( Factor x ) {
     using namespace pure::list::taking;
     using namespace pure::list::misc;
-    return (primes <= std::sqrt(x)) / divisorOf(x);
+    // 1 counts too, so that _lowFactors' products include each prime.
+    return append( Factors{1}, (primeSeq <= std::sqrt(x)) / divisorOf(x) );
 }
 
 Factors lowFactors( Factor x ) {
@@ -495,36 +430,13 @@ void problem13() {
 
     cout << "The first 10 digits of the sum is : " << flush;
 
-    using DS = std::vector<Digits>;
-
-    auto nums = mapExactly<DS> (
-        digits,
+    auto nums = mapExactly<std::vector<BigInt>> (
+        Make<BigInt>(),
         io::fileContents<std::string>(fin) 
     );
 
-    Digits r;
-
-    {
-        using namespace pure::set; // For reverse (-s)
-                                   // and append (s+s)
-        // Note: pure::set overloads <<, so it cannot be used with std::cout.
-        unsigned int carry = 0;
-        auto sum = -map (
-            [&]( unsigned int i ) {
-                unsigned int sum = carry;
-                for( auto j : enumerate(nums) )
-                    sum += nums[j][i];
-                carry = sum / 10;
-                return sum % 10;
-            },
-            // Reverse the order of the columns: LSD first.
-            -dupTo<std::vector>( enumerate(nums[0]) )
-        );
-
-        r = digits(carry) + take( 8, sum );
-    }
-
-    cout << r << endl;
+    auto ds = sum( nums ).digits();
+    cout << Digits( begin(ds), begin(ds) + 10 ) << endl;
 }
 
 unsigned int e14Iterate( unsigned int x ) {
@@ -623,12 +535,11 @@ void problem15() {
 
 void problem16() {
     cout << "The sum of " << flush;
-    Digits ds = { 2 };
-    for( unsigned int power = 1; power < 1000; power++ ) {
-        ds = move(ds) * 2;
-    }
+    BigInt x = 2;
+    for( unsigned int power = 1; power < 1000; power++ )
+        x *= 2;
     cout << "2^1000 is " << flush;
-    cout << sum(ds) << endl;
+    cout << sum( x.digits() ) << endl;
 }
 
 std::string ones( unsigned int x ) {
@@ -752,10 +663,7 @@ void problem19() {
 
 void problem20() {
     cout << "The sum of !100 = " << flush;
-    Digits ds = { 1 };
-    for( unsigned int x = 100; x > 1; x-- )
-        ds = move(ds) * x;
-    cout << sum(ds) << endl;
+    cout << sum( foldl(Mult(), BigInt(1), enumerate(2,100)).digits() ) << endl;
 }
 
 void problem21() {
@@ -836,31 +744,15 @@ void problem24() {
     cout << permutations(ds)[1_M-1] << endl;
 }
 
-struct Fib {
-    Digits i, j, r;
-    Fib() : i{3}, j{5}, r{2} { }
-};
-
-Fib nextFib( Fib f ) {
-    auto tmp = f.j;
-    f.j = f.i + f.j;
-    f.i = tmp;
-    return f;
-}
-
-std::string toString( const Digits& ds ) {
-    return mapExactly<std::string> (
-        []( int x ) { return x + '0'; },
-        ds
-    );
-}
-
 void problem25() {
     cout << "The first Fibonacci number with 1000 digits : " << flush;
-    Fib fib;
-    unsigned long long term = 5; // F5 = 5 and Fib starts on 5.
-    for( ; length(fib.j) != 1000; term++ )
-        fib = nextFib( fib );
+    const BigInt least( "1" + std::string(999,'0') );
+    BigInt i = 3, j = 5;
+    unsigned long long term = 5; // F5 = 5.
+    for( ; j < least; term++ ) {
+        i += j;
+        std::swap( i, j );
+    }
     cout << term << endl;
 }
 
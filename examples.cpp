@@ -5,6 +5,13 @@
 #include "State.h"
 #include "Applicative.h"
 #include "Set.h"
+#include "Lazy.h"
+#include "Parallel.h"
+#include "Persistent.h"
+#include "Comprehension.h"
+#include "Primes.h"
+#include "BigInt.h"
+#include "Arena.h"
 
 #include <cstdio>
 #include <cmath>
@@ -96,6 +103,7 @@ template< class S > auto show( const S& s )
     -> decltype( std::begin(s), string() );
 template< class X > string showJust( const X& );
 template< class X > string show( const unique_ptr<X>& );
+template< class X > string show( const data::Maybe<X>& );
 template< class X > string show( X* );
 
 string show( bool b ) {
@@ -193,13 +201,16 @@ template<> string show( const std::tuple<>& ) {
 
 template< class X > string showJust( const X& x );
 template< class M > string showMaybe( const M& m ) {
-    using X = decltype( *declval<M>() );
+    using X = Decay<decltype( *declval<M>() )>;
     return maybe( string("Nothing"), showJust<X>, m );
 }
 
 template< class X > string show( const unique_ptr<X>& m ) {
     return showMaybe( m );
 }
+template< class X > string show( const data::Maybe<X>& m ) {
+    return showMaybe( m );
+}
 template< class X > string show( X* m ) {
     return showMaybe( m );
 }
@@ -334,6 +345,8 @@ int main()
         printf( "\ttail es = %s\n\tinit es = %s\n",
                 show( tail(evens) ).c_str(), show( init(evens) ).c_str() );
         printf( "\tinits es = %s\n", show( inits(evens) ).c_str() );
+        printf( "\ttails es = %s\n",
+                show( lazy::tails(evens) ).c_str() );
         printf( "\treverse es = %s\n", show( pure::list::reverse(evens) ).c_str() );
         printf( "\telem 2 es = %s\n",   show( elem(  2,evens) ).c_str() );
         printf( "\tdeleteFirstBy (==) es [2,6] = %s\n",
@@ -347,6 +360,19 @@ int main()
         printf( "\tscanr (+) %s = %s\n",
                 show( evens ).c_str(), show( scanr( Add(), evens ) ).c_str() );
 
+        // A strided range answers these from its ends, without iterating.
+        auto odds = enumerate( 1, 99, 2 );
+        printf( "\nlet os = [1,3..99]\n" );
+        printf( "\tlength os = %lu\n", length(odds) );
+        printf( "\tsum os = %u\n", sum(odds) );
+        printf( "\telem 51 os = %s\n", show( elem(51u,odds) ).c_str() );
+        printf( "\ttake 3 (drop 10 os) = %s\n",
+                show( take( 3, drop(10,odds) ) ).c_str() );
+        printf( "\tfilter (divisibleBy 7) os = %s\n",
+                show( filter( divisibleBy(7), odds ) ).c_str() );
+        printf( "\tintersect os [0,5..99] = %s\n",
+                show( intersect( odds, enumerate(0,99,5) ) ).c_str() );
+
         {
             using namespace pure::set::ordered;
             printf( "\npure::set :\n"
@@ -363,6 +389,41 @@ int main()
 
             printf( "['a','b'] * evens = %s\n",
                     show( S('a','b') * S(1,2) ).c_str() );
+            // The pairs are made as they're read, not stored.
+            auto sumIs = []( int n ) {
+                return [n]( std::pair<int,int> p ) {
+                    return p.first + p.second == n;
+                };
+            };
+            printf( "find ((==10) . sum) (es * es) = %s\n",
+                    show( *find( sumIs(10), evens * evens ) ).c_str() );
+            printf( "any ((==12) . sum) (es * es) = %s\n",
+                    show( any( sumIs(12), evens * evens ) ).c_str() );
+            printf( "filter ((==10) . sum) (es * es) = %s\n",
+                    show( list::filter( sumIs(10), evens * evens ) ).c_str() );
+
+            FlatSet<int> fs;
+            for( int x : { 9, 3, 7, 3, 1 } )
+                fs <<= x;
+            const FlatSet<int> fes( begin(evens), end(evens) );
+            printf( "FlatSet from 9, 3, 7, 3, 1 = %s\n", show(fs).c_str() );
+            printf( "fs | es = %s\n", show( fs | fes ).c_str() );
+            printf( "(fs << 2 << 4) %% es = %s\n",
+                    show( (fs << 2 << 4) % fes ).c_str() );
+            printf( "es / (fs << 4) = %s\n",
+                    show( fes / (fs << 4) ).c_str() );
+        }
+
+        {
+            using namespace pure::set::generic;
+            const vector<int> xs = { 9, 2, 7, 4 }, ys = { 4, 5, 9 };
+            printf( "\npure::set::generic (hashed) :\n"
+                    "%s | %s = %s\n", show(xs).c_str(), show(ys).c_str(),
+                    show( xs | ys ).c_str() );
+            printf( "%s / %s = %s\n", show(xs).c_str(), show(ys).c_str(),
+                    show( xs / ys ).c_str() );
+            printf( "%s %% %s = %s\n", show(xs).c_str(), show(ys).c_str(),
+                    show( xs % ys ).c_str() );
         }
 
         puts("");
@@ -380,6 +441,52 @@ int main()
                 show( take( 10, iterate(add(2),1) ) ).c_str() );
         printf( "replicate 10 1 = %s\n",
                 show( replicate(10, 1) ).c_str() );
+
+        // Room for 8, on the stack: map and filter give StaticVecs back.
+        auto small = misc::SV<8>( 3, 1, 4, 1, 5 );
+        printf( "filter odd (map (+2) (SV<8> 3 1 4 1 5 ++ [9])) = %s\n",
+                show( filter( fnot(even),
+                              map( add(2), append(small, misc::SV(9)) ) ) )
+                    .c_str() );
+
+        // Each version shares all it can with the last.
+        const persistent::Vector<int> pv = { 1, 2, 3, 4 };
+        const auto pv2 = cons( tail(pv), 5 );
+        printf( "let pv = %s; cons (tail pv) 5 = %s; pv = %s\n",
+                show(pv).c_str(), show(pv2).c_str(), show(pv).c_str() );
+        printf( "take 5 $ filter even $ map (*3) [1..] = %s\n",
+                show( lazy::take( 5, lazy::filter(even,
+                          lazy::map(mult(3), enumerate(1u))) ) ).c_str() );
+        printf( "take 4 $ permutations \"abc\" = %s\n",
+                show( lazy::take( 4, lazy::permutations(string("abc")) ) )
+                    .c_str() );
+        printf( "takeWhile (<20) $ iterate (+3) 1 = %s\n",
+                show( dupTo<std::vector>( lazy::takeWhile (
+                    less.with(20), iterate(add(3),1)
+                ) ) ).c_str() );
+        printf( "take 10 $ biIterate (+) 1 1 = %s\n",
+                show( take( 10, biIterate(Add(),1,1) ) ).c_str() );
+        printf( "take 10 $ iterateN<3> (\\a b c->a+b+c) 0 0 1 = %s\n",
+                show( take( 10, iterateN<3>(
+                    []( int a, int b, int c ) { return a + b + c; }, 0, 0, 1
+                ) ) ).c_str() );
+        printf( "[ (a,b,c) | a <- [1..20], b <- [a..20], c <- [b..20], "
+                "a^2+b^2==c^2 ] = %s\n",
+                show( comprehend (
+                    []( unsigned int a, unsigned int b, unsigned int c ) {
+                        return std::make_tuple( a, b, c );
+                    },
+                    from( enumerate(1,20) ),
+                    bindWith( []( unsigned int a ) {
+                        return enumerate( a, 20 );
+                    } ),
+                    bindWith( []( unsigned int, unsigned int b ) {
+                        return enumerate( b, 20 );
+                    } ),
+                    when( []( unsigned int a, unsigned int b, unsigned int c ) {
+                        return a*a + b*b == c*c;
+                    } )
+                ) ).c_str() );
         puts("");
 
         printf( "break even [1..8] = %s\n",
@@ -392,6 +499,11 @@ int main()
                 show( nub(string("footoonopor")) ).c_str() );
         printf( "\"footo\" `union` \"onopor\" = %s\n",
                 show( sunion(string("footo"),string("onopor")) ).c_str() );
+        const string sentence = "  the quick  brown fox";
+        printf( "words \"%s\" = %s\n", sentence.c_str(),
+                show( words(sentence) ).c_str() );
+        printf( "length $ lazy::words \"%s\" = %s\n", sentence.c_str(),
+                show( length(lazy::words(sentence)) ).c_str() );
 
         // isspace is a macro, so we need to wrap it to pass it.
         auto is_space = [](char c){ return isspace(c); };
@@ -400,6 +512,17 @@ int main()
         printf( "dropWhileEnd isspace \"foo\\n\" = %s\n",
                 show( dropWhileEnd(is_space, string("foo\n")) ).c_str() );
 
+        // "one\ntwo three\nfour\n", mapped from a file.
+        std::ofstream( "mapped.txt" ) << "one\ntwo three\nfour\n";
+        auto mapped = io::mappedContents( "mapped.txt" );
+        printf( "length $ io::lines mapped = %s\n",
+                show( length(io::lines(mapped)) ).c_str() );
+        printf( "length $ io::words mapped = %s\n",
+                show( length(io::words(mapped)) ).c_str() );
+        printf( "filter (=='o') mapped = %s\n",
+                show( filter(eq('o'), mapped) ).c_str() );
+        std::remove( "mapped.txt" );
+
         puts("");
 
         printf( "3^2 = %d\n", square(3) );
@@ -412,6 +535,9 @@ int main()
             "sum of (4,3,2,1) = %d\n", // = 10
             foldr( Add(), {1,2,3,4} )
         );
+        vector<float> fs = { 2.5f, -1, 8, 0.5f };
+        printf( "sum %s = %g\n", show(fs).c_str(), sum(fs) );
+        printf( "minmax %s = %s\n", show(fs).c_str(), show(minmax(fs)).c_str() );
         printf(
             "map (+1) [1,2,3,4] = %s\n", // = 10
             show( fmap( add(1), {1,2,3,4} ) ).c_str()
@@ -644,8 +770,51 @@ int main()
         printf( "Just(+2) `ap` Just 5 = %s\n",
                 show( monad::ap(Just(add(2)),Just(5)) ).c_str() );
 
-        printf( "mfilter even toFour = %s",
+        printf( "mfilter even toFour = %s\n",
                 show( mfilter(even,toFour) ).c_str() );
+
+        // The same, stored inline: no allocations.
+        using data::Maybe;
+        auto half = []( int x ) {
+            return x % 2 == 0 ? Inline( x / 2 ) : nullptr;
+        };
+        printf( "Inline 12 >>= half >>= half = %s\n",
+                show( (Inline(12) >>= half) >>= half ).c_str() );
+        printf( "Inline 12 >>= half >>= half >>= half = %s\n",
+                show( ((Inline(12) >>= half) >>= half) >>= half ).c_str() );
+        printf( "liftM2 (+) (Inline 1) (Inline 2) = %s\n",
+                show( liftM(add, Inline(1), Inline(2)) ).c_str() );
+        printf( "mfilter even (Inline 3) = %s\n",
+                show( mfilter(even, Inline(3)) ).c_str() );
+        printf( "Nothing `mplus` Inline 2 = %s\n",
+                show( Maybe<int>() + Inline(2) ).c_str() );
+
+        auto halfE = []( int x ) {
+            return x % 2 == 0 ? Right<string>( x / 2 )
+                              : Left<int>( std::to_string(x) + " is odd" );
+        };
+        printf( "Right 12 >>= half >>= half = %s\n",
+                show( (Right<string>(12) >>= halfE) >>= halfE ).c_str() );
+        printf( "Right 12 >>= half >>= half >>= half = %s",
+                show( ((Right<string>(12) >>= halfE) >>= halfE) >>= halfE )
+                    .c_str() );
+        puts("");
+
+        auto addSmall = []( unsigned long acc, int x ) {
+            return x < 1000000 ? Inline( acc + x ) : nullptr;
+        };
+        auto upTo = list::enumerate( 1, 999999 );
+        auto million = list::enumerate( 1, 1000000 );
+        printf( "foldM addSmall 0 [1..999999] = %s\n",
+                show( foldM(addSmall, 0ul, upTo) ).c_str() );
+        printf( "foldM addSmall 0 [1..1000000] = %s\n",
+                show( foldM(addSmall, 0ul, million) ).c_str() );
+
+        std::vector< Either<string,int> > es = {
+            Right<string>(1), Left<int>(string("two")), Right<string>(3)
+        };
+        printf( "sequence [Right 1, Left \"two\", Right 3] = %s",
+                show( sequence(es) ).c_str() );
         auto evens = std::vector<int>{1} >>= []( int x ) -> std::vector<int> { return x%2==0? std::vector<int>{x} : std::vector<int>{}; };
 
         puts("");
@@ -690,6 +859,94 @@ int main()
         printf( "mconcat (map Product v) = %s\n",
                 show( mconcat(Make<Product>() ^ stuff) ).c_str() );
 
+        std::vector< int > big = list::replicate( 1000000, 2 );
+        printf( "parallel foldMap Sum (replicate 1000000 2) = %s\n",
+                show( parallel::foldMap(Make<Sum>(), big) ).c_str() );
+        printf( "parallel mconcat (map (\\x->[x]) [1..5]) = %s\n",
+                show( parallel::mconcat (
+                    list::map( [](int x){ return vector<int>{x}; },
+                               list::enumerate(1,5) )
+                ) ).c_str() );
+
+        // No fixed points: p !! i /= i for every i.
+        auto derangement = []( const vector<unsigned int>& p ) {
+            for( size_t i = 0; i < p.size(); i++ )
+                if( p[i] == i )
+                    return Sum(0);
+            return Sum(1);
+        };
+        printf( "parallel foldMap derangement (permutations [0..9]) = %s\n",
+                show( parallel::foldMap( derangement,
+                          list::lazy::permutations (
+                              list::dupTo<std::vector>( list::enumerate(0,9) )
+                          ) )
+                ).c_str() );
+
+        // ns = [1..2000]: count the coprime pairs, split by rows.
+        const auto ns = list::dupTo<std::vector>( list::enumerate(1,2000) );
+        auto coprime = []( std::pair<int,int> p ) {
+            return Sum( list::progression::gcd( p.first, p.second ) == 1 );
+        };
+        printf( "parallel foldMap coprime (cartesian ns ns) = %s\n",
+                show( parallel::foldMap( coprime,
+                                         list::lazy::cartesian(ns,ns) ) )
+                    .c_str() );
+
+        // The same calls, split across threads by an execution policy.
+        auto squareMod = []( unsigned long x ) { return x * x % 1000; };
+        auto shuffled = list::map( squareMod, list::enumerate(1,100000) );
+        printf( "let xs = map (\\x -> x*x mod 1000) [1..100000]\n" );
+        printf( "take 5 (map (par) (+1) xs) = %s\n",
+                show( list::take( 5, list::map( par, add(1u), shuffled ) ) )
+                    .c_str() );
+        printf( "length (filter (par) (< 10) xs) = %lu\n",
+                (unsigned long) list::length (
+                    list::filter( par, less.with(10u), shuffled )
+                ) );
+        printf( "any (par_unseq) (== 999) xs = %s\n",
+                show( list::any( par_unseq, eq(999u), shuffled ) ).c_str() );
+        printf( "find (par) (> 995) xs = %s\n",
+                show( *list::find( par, greater.with(995u), shuffled ) ).c_str() );
+        printf( "take 5 (reverse (sort (par) xs)) = %s\n",
+                show( list::take( 5, list::reverse (
+                    list::sort( par, shuffled )
+                ) ) ).c_str() );
+
+        // Route each x to the first bucket whose predicate holds.
+        auto buckets = parallel::fork( shuffled, less.with(10u),
+                                       greater.with(990u) );
+        printf( "map length (fork (par) xs (< 10) (> 990)) = [%lu,%lu,%lu]\n",
+                (unsigned long) std::get<0>(buckets).size(),
+                (unsigned long) std::get<1>(buckets).size(),
+                (unsigned long) std::get<2>(buckets).size() );
+
+        auto ps = list::primes();
+        printf( "take 10 primes = %s\n", show( list::take(10,ps) ).c_str() );
+        printf( "primes !! 100000 = %lu\n",
+                (unsigned long) *std::next( begin(ps), 100000 ) );
+        printf( "length (primesUpTo 10000000) = %lu\n",
+                (unsigned long) list::length( list::primesUpTo(10000000) ) );
+
+        auto fact = list::foldl( Mult(), BigInt(1), list::enumerate(1,30) );
+        printf( "foldl (*) 1 [1..30] = %s\n", fact.str().c_str() );
+        printf( "sum (digits (foldl (*) 1 [1..30])) = %u\n",
+                list::sum( fact.digits() ) );
+        printf( "2^100 - 3^70 = %s\n",
+                ( pow(BigInt(2),100) - pow(BigInt(3),70) ).str().c_str() );
+        BigInt thousand = parallel::foldMap( Make<BigProduct>(),
+                                             list::enumerate(1u,1000u) );
+        printf( "length (digits (parallel foldMap BigProduct [1..1000])) = "
+                "%lu\n", (unsigned long) thousand.digits().size() );
+
+        // Every intermediate comes from the arena, and goes when it does.
+        Arena arena;
+        long squares = with_arena( arena, [] {
+            auto xs = list::dupTo<ArenaVector>( list::enumerate(1,1000) );
+            auto sq = list::map( []( int x ) { return long(x) * x; }, xs );
+            return list::sum( list::filter( even, sq ) );
+        } );
+        printf( "with_arena: sum (filter even (map (^2) [1..1000])) = %ld\n",
+                squares );
     }
 
     {
@@ -1,5 +1,6 @@
 
 #include "../Pure.h"
+#include "../Lazy.h"
 
 #include <vector>
 #include <array>
@@ -25,6 +26,14 @@ unsigned int headOnly( const VUI& v ) {
     return head( map( fact, v ) );
 }
 
+unsigned int headOnlyLazy( const VUI& v ) {
+    // lazy::map computes fact only for the elements read, so this is the
+    // same as fact( head(v) ) and allocates nothing.
+    using pure::list::lazy::map;
+    using pure::list::head;
+    return head( map( fact, v ) );
+}
+
 constexpr unsigned int headOnlyA( const Arr& a ) {
     using pure::list::map;
     using pure::list::head;
@@ -479,6 +488,7 @@ int main() {
     using std::endl;
 
     cout << headOnly( {1,2,3,4} ) << endl;
+    cout << headOnlyLazy( {1,2,3,4} ) << endl;
 
     // GCC does not produce an assembly version of headOnlyA, but it does
     // inline it here, which shows that even though it has been labelled
@@ -996,6 +996,11 @@ constexpr struct split {
  * Returns a tuple, {leftovers,xs0,xs1,...,xsn}, where xsN is every x from xs
  * such that predN(x) is true. leftovers contains every x for which no
  * predicate is true.
+ *
+ * One pass: each x is tested against the predicates in order until one
+ * matches, then moved once, either to its resultant or down over the gap
+ * the moved ones left. Every resultant, and the leftovers, keep the order of
+ * xs. (See parallel::fork for one that splits xs across threads.)
  */
 // Ref version.
 constexpr struct Fork_ : Binary<Fork_> {
@@ -1004,6 +1009,9 @@ constexpr struct Fork_ : Binary<Fork_> {
     template< class XS, class ...P >
     using Forked = decltype( repeat<sizeof...(P)>(XS()) );
 
+    template< bool when >
+    using EnableWhen = typename std::enable_if< when, bool >::type;
+
     // First, convert ps... to a tuple.
     template< class XS, class ...P >
     Forked<XS,P...> operator () ( XS& xs, P&& ...ps ) const {
@@ -1014,22 +1022,47 @@ constexpr struct Fork_ : Binary<Fork_> {
     template< class XS, class ...P >
     static Forked<XS,P...> doFork( XS& xs, const std::tuple<P...>& ps ) {
         Forked<XS,P...> r;
+        xs.erase( partition( std::begin(xs), std::end(xs), r, ps ),
+                  std::end(xs) );
+        return r;
+    }
 
-        auto it = std::begin(xs);
-        for( ; it != std::end(xs); ) {
-            // doSendWhen will try to move *it when a predicate is matched.
-            if( doSendWhen<0>( *it, r, ps ) )
-                // Thusly, take out the moved element.
-                it = xs.erase(it);
-            else
-                it++;
+    /*
+     * Send each matched x in [b,e) to its resultant in dsts, and pack the
+     * leftovers, in order, at the front. Returns the end of the leftovers.
+     */
+    template< class I, class Dsts, class Preds >
+    static I partition( I b, I e, Dsts& dsts, const Preds& ps ) {
+        I out = b;
+        for( ; b != e; ++b ) {
+            // doSendWhen will try to move *b when a predicate is matched.
+            if( doSendWhen<0>( *b, dsts, ps ) )
+                continue;
+            if( out != b )
+                *out = std::move( *b );
+            ++out;
         }
+        return out;
+    }
 
-        return r;
+    /* Move each of src's resultants onto the end of dst's. */
+    template< size_t N = 0, class Dsts >
+    static auto appendEach( Dsts&, Dsts& )
+        -> EnableWhen< N >= size<Dsts>() >
+    {
+        return true;
     }
 
-    template< bool when >
-    using EnableWhen = typename std::enable_if< when, bool >::type;
+    template< size_t N = 0, class Dsts >
+    static auto appendEach( Dsts& dst, Dsts& src )
+        -> EnableWhen<( N < size<Dsts>() )>
+    {
+        auto& d = std::get<N>( dst );
+        auto& s = std::get<N>( src );
+        d.insert( std::end(d), std::make_move_iterator( std::begin(s) ),
+                               std::make_move_iterator( std::end(s) ) );
+        return appendEach<N+1>( dst, src );
+    }
 
     // Check each predicate and send it to the correct resultant.
     // If nothing matched, send x to the leftovers.